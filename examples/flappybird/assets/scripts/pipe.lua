@@ -12,6 +12,7 @@ function onTick()
     if me.position.x < -500 then
         me.position.x = 500
         me.position.y = randf_between(-100, 100)
+        me:ResetInterpolation()
     end
 end
 
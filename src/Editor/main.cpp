@@ -8,6 +8,7 @@
 #include <Radium/Input.hpp>
 #include <Radium/Nodes/2D/RigidBody.hpp>
 #include <Radium/Nodes/2D/Sprite2D.hpp>
+#include <Radium/Nodes/2D/SpriteInstances2D.hpp>
 #include <Radium/Nodes/ClassDB.hpp>
 #include <Radium/Nodes/LuaScript.hpp>
 #include <Radium/SpriteBatchRegistry.hpp>
@@ -397,6 +398,8 @@ public:
 
   void OnLoad() override {
     scene = new Radium::SubViewport(1280, 720);
+    // The editor always edits the JSON scene, never a baked copy
+    scene->tree.preferBinaryScenes = false;
     // REENABLE ME IF IT FAILS
     Rune::Texture *tex = new Rune::Texture(scene->viewport->textureView,
                                            Rune::SamplingMode::Nearest);
@@ -404,6 +407,7 @@ public:
     Radium::Nodes::Node::Register();
     Radium::Nodes::Node2D::Register();
     Radium::Nodes::Sprite2D::Register();
+    Radium::Nodes::SpriteInstances2D::Register();
     Radium::Nodes::RigidBody::Register();
     Radium::Camera::Register();
 
@@ -572,6 +576,12 @@ public:
     ImGui::PopID();
   }
 
+  // Save the JSON scene and bake a binary copy next to it for the runtime
+  void SaveScene(const std::string &path) {
+    scene->tree.Serialize(path);
+    scene->tree.SerializeBinary(path + "b");
+  }
+
   void ImGuiTextEdit(const std::string &label, std::string &val) {
     // Use a persistent per-node+property buffer so multiple InputText fields
     // don't share the same backing memory (which causes collisions and
@@ -636,7 +646,7 @@ public:
           break;
 
         case 2: // save
-          scene->tree.Serialize(relativePath);
+          SaveScene(relativePath);
           openPath = relativePath;
           break;
 
@@ -738,7 +748,7 @@ public:
                   "ChooseFileDlgKey", "Save JSON Scene", ".json", config);
             } else {
               Flux::Info("Open path {}", openPath);
-              scene->tree.Serialize(
+              SaveScene(
                   (fs::path(projectFolder) / openPath).generic_string());
             }
           }
@@ -796,7 +806,7 @@ public:
                 "ChooseFileDlgKey", "Save JSON Scene", ".json", config);
           } else {
             Flux::Info("Open path {}", openPath);
-            scene->tree.Serialize(
+            SaveScene(
                 (fs::path(projectFolder) / openPath).generic_string());
           }
         }
@@ -868,7 +878,7 @@ public:
 
         ImGui::Separator();
 
-        for (auto property :
+        for (const auto &property :
              Radium::Nodes::ClassDB::GetProperties(selectedNode)) {
           ImGui::PushID(selectedNode);
           ImGui::PushID(property.name.c_str());
@@ -877,15 +887,21 @@ public:
             ImGui::PopID();
             continue;
           }
-          if (Radium::Nodes::ClassDB::IsEnum(property.type)) {
+          Radium::Nodes::ClassDB::PropertyId id =
+              Radium::Nodes::ClassDB::ResolveProperty(property);
+
+          switch (property.kind) {
+          case Radium::Nodes::ClassDB::PropertyKind::Enum:
+          case Radium::Nodes::ClassDB::PropertyKind::Int: {
             int *f = Radium::Nodes::ClassDB::GetPropertyPointer<int>(
-                property.name, selectedNode);
+                id, selectedNode);
             ImGui::InputInt(property.name.c_str(), f);
+            break;
           }
-          if (property.type == "Radium::Vector2f") {
+          case Radium::Nodes::ClassDB::PropertyKind::Vector2f: {
             Radium::Vector2f *value =
                 Radium::Nodes::ClassDB::GetPropertyPointer<Radium::Vector2f>(
-                    property.name, selectedNode);
+                    id, selectedNode);
 
             float val[2] = {value->x, value->y};
 
@@ -893,50 +909,42 @@ public:
 
             value->x = val[0];
             value->y = val[1];
+            break;
           }
-#if !defined(_MSC_VER)
-          if (property.type ==
-              "std::__cxx11::basic_string<char, std::char_traits<char>, "
-              "std::allocator<char> >") {
-#else
-          if (property.type ==
-              "std::basic_string<char,struct std::char_traits<char>,class "
-              "std::allocator<char> >") {
-#endif
+          case Radium::Nodes::ClassDB::PropertyKind::String: {
             // Edit the actual property string in-place. Use GetPropertyPointer
             // so changes persist back to the node.
             std::string *strPtr =
                 Radium::Nodes::ClassDB::GetPropertyPointer<std::string>(
-                    property.name, selectedNode);
+                    id, selectedNode);
             if (strPtr) {
               ImGuiTextEdit(property.name, *strPtr);
             }
+            break;
           }
-          if (property.type == "float") {
+          case Radium::Nodes::ClassDB::PropertyKind::Float: {
             float *f = Radium::Nodes::ClassDB::GetPropertyPointer<float>(
-                property.name, selectedNode);
+                id, selectedNode);
             ImGui::InputFloat(property.name.c_str(), f);
+            break;
           }
-          if (property.type == "unsigned int") {
+          case Radium::Nodes::ClassDB::PropertyKind::UnsignedInt: {
             unsigned int *f =
                 Radium::Nodes::ClassDB::GetPropertyPointer<unsigned int>(
-                    property.name, selectedNode);
+                    id, selectedNode);
             ImGui::InputScalar(property.name.c_str(), ImGuiDataType_U32, f);
+            break;
           }
-          if (property.type == "int") {
-            int *f = Radium::Nodes::ClassDB::GetPropertyPointer<int>(
-                property.name, selectedNode);
-            ImGui::InputInt(property.name.c_str(), f);
-          }
-          if (property.type == "bool") {
+          case Radium::Nodes::ClassDB::PropertyKind::Bool: {
             bool *f = Radium::Nodes::ClassDB::GetPropertyPointer<bool>(
-                property.name, selectedNode);
+                id, selectedNode);
             ImGui::Checkbox(property.name.c_str(), f);
+            break;
           }
-          if (property.type == "Radium::RectangleF") {
+          case Radium::Nodes::ClassDB::PropertyKind::RectangleF: {
             Radium::RectangleF *value =
                 Radium::Nodes::ClassDB::GetPropertyPointer<Radium::RectangleF>(
-                    property.name, selectedNode);
+                    id, selectedNode);
 
             float pos[2] = {value->x, value->y};
             float size[2] = {value->w, value->h};
@@ -952,11 +960,16 @@ public:
               value->w = size[0];
               value->h = size[1];
             }
+            break;
           }
-          if (property.type == "Radium::Nodes::Node*") {
+          case Radium::Nodes::ClassDB::PropertyKind::Pointer: {
+            // Only node references can be assigned from the editor
+            if (property.type != "Radium::Nodes::Node*")
+              break;
+
             Radium::Nodes::Node **ptr =
                 Radium::Nodes::ClassDB::GetPropertyPointer<
-                    Radium::Nodes::Node *>(property.name, selectedNode);
+                    Radium::Nodes::Node *>(id, selectedNode);
 
             if (ptr && *ptr)
               ImGui::Text("%s: %s", property.name.c_str(),
@@ -978,6 +991,10 @@ public:
               }
               ImGui::EndDragDropTarget();
             }
+            break;
+          }
+          default:
+            break;
           }
 
           ImGui::PopID();
@@ -1076,7 +1093,7 @@ public:
           if (ImGui::Selectable(file.c_str())) {
             if (endsWith(file, ".rscn")) {
               if (openPath != "")
-                scene->tree.Serialize(openPath);
+                SaveScene(openPath);
               fs::path path = fs::path(folder) / file;
               Flux::Info("Scene: {}", path.generic_string());
               scene->tree.Deserialize(path.generic_string(), true, true);
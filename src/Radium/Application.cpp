@@ -15,8 +15,12 @@
 #include <emscripten/html5.h>
 #endif
 #include <Radium/SpriteBatchRegistry.hpp>
+#include <Radium/Nodes/LuaScript.hpp>
 #include <tracy/Tracy.hpp>
 #include <tracy/TracyC.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #ifdef __ANDROID__
 
 #endif
@@ -25,25 +29,110 @@ namespace Radium
 {
 	Application *currentApplication;
 
-	Application::Application()
+	Application::Application() : startTime(std::chrono::steady_clock::now())
 	{
 #ifdef __ANDROID__
 
 #endif
 
+		if (const char *env = std::getenv("RADIUM_HEADLESS"))
+		{
+			headless = std::string(env) != "0";
+		}
+		if (const char *env = std::getenv("RADIUM_HEADLESS_FRAMES"))
+		{
+			headlessFrames = std::atoi(env);
+		}
+
 		Flux::Trace("Constructed application {}", this->GetTitle());
 	}
 
-	void Application::Run()
+	void Application::ParseArguments(int argc, char *argv[])
 	{
-		OnEarlyLoad();
+		for (int i = 1; i < argc; i++)
+		{
+			std::string arg = argv[i];
 
-		Flux::Trace("Initializing SDL");
+			if (arg == "--headless")
+			{
+				headless = true;
+			}
+			else if (arg == "--frames" && i + 1 < argc)
+			{
+				headlessFrames = std::atoi(argv[++i]);
+			}
+			else if (arg == "--hot-reload")
+			{
+				hotReloadScripts = true;
+			}
+			else if (arg == "--profile-scripts")
+			{
+				Nodes::Lua::profiler.enabled = true;
+			}
+		}
+	}
 
-		Iris::codecs.push_back(std::make_unique<Iris::PNGCodec>());
-		Iris::codecs.push_back(std::make_unique<Iris::BMPCodec>());
+	void Application::Quit(int exitCode)
+	{
+		this->exitCode = exitCode;
+		running = false;
 
-		Flux::Trace("Initialized SDL successfuly");
+#ifdef __EMSCRIPTEN__
+		emscripten_cancel_main_loop();
+#endif
+	}
+
+	int Application::GetExitCode()
+	{
+		return exitCode;
+	}
+
+	void *Application::EnqueuePhysicsTask(b2TaskCallback *task, int itemCount, int minRange, void *taskContext, void *userContext)
+	{
+		Application *app = static_cast<Application *>(userContext);
+		JobSystem *jobs = app->jobSystem.get();
+
+		// Never run the task inline here, the solver enqueues worker loops that spin until the
+		// calling thread signals them, so they must be picked up by other threads
+		if (app->physicsTaskCount == app->physicsTasks.size())
+		{
+			app->physicsTasks.push_back(std::make_unique<JobGroup>());
+		}
+		JobGroup *group = app->physicsTasks[app->physicsTaskCount++].get();
+
+		int threadCount = (int)jobs->GetThreadCount();
+		int rangeSize = std::max(minRange, (itemCount + threadCount - 1) / threadCount);
+
+		for (int begin = 0; begin < itemCount; begin += rangeSize)
+		{
+			int end = std::min(begin + rangeSize, itemCount);
+			jobs->Run(*group, [jobs, task, taskContext, begin, end]()
+					  {
+				ZoneScopedN("Physics Task");
+				task(begin, end, jobs->GetCurrentWorkerIndex(), taskContext); });
+		}
+
+		return group;
+	}
+
+	void Application::FinishPhysicsTask(void *userTask, void *userContext)
+	{
+		Application *app = static_cast<Application *>(userContext);
+		app->jobSystem->Wait(*static_cast<JobGroup *>(userTask));
+	}
+
+	JobSystem *Application::GetJobSystem()
+	{
+		return jobSystem.get();
+	}
+
+	bool Application::IsHeadless()
+	{
+		return headless;
+	}
+
+	void Application::InitializeGraphics()
+	{
 		Flux::Trace("Creating window");
 
 		Radium::Vector2i size = this->GetPreferredSize();
@@ -107,12 +196,50 @@ namespace Radium
 #endif
 
 		Radium::DebugRenderer::Setup();
+	}
+
+	void Application::Run()
+	{
+		OnEarlyLoad();
+
+		Flux::Trace("Initializing SDL");
+
+		Iris::codecs.push_back(std::make_unique<Iris::PNGCodec>());
+		Iris::codecs.push_back(std::make_unique<Iris::BMPCodec>());
+
+		Flux::Trace("Initialized SDL successfuly");
+
+		if (headless)
+		{
+			Flux::Info("Running headless, skipping window, Rune and ImGui");
+			SpriteBatchRegistry::SetHeadless(true);
+		}
+		else
+		{
+			InitializeGraphics();
+		}
+
+		jobSystem = std::make_unique<JobSystem>(jobThreadCount);
 
 		Flux::Trace("Creating physics stuff");
 
 		b2WorldDef worldDef = b2DefaultWorldDef();
 		worldDef.gravity = {GetGravity().x, GetGravity().y};
 
+		// Box2D indexes per-worker data by our worker slot, so every slot must fit under its limit
+		constexpr unsigned int maxPhysicsWorkers = 64;
+		if (jobSystem->GetThreadCount() > maxPhysicsWorkers)
+		{
+			Flux::Warn("{} job threads is more than Box2D supports, physics will run on the main thread", jobSystem->GetThreadCount());
+		}
+		else if (jobSystem->GetThreadCount() > 1)
+		{
+			worldDef.workerCount = (int)jobSystem->GetThreadCount();
+			worldDef.enqueueTask = &Application::EnqueuePhysicsTask;
+			worldDef.finishTask = &Application::FinishPhysicsTask;
+			worldDef.userTaskContext = this;
+		}
+
 		worldId = b2CreateWorld(&worldDef);
 
 		Flux::Trace("Done");
@@ -125,22 +252,34 @@ namespace Radium
 
 #ifdef __EMSCRIPTEN__
 		emscripten_set_main_loop([]()
-								 { Radium::currentApplication->RunFrame(0); }, 0,
+								 { Radium::currentApplication->RunFrame(Radium::currentApplication->GetTime()); }, 0,
 								 1);
 
 #else
 		this->running = true;
 
+		double loopStart = GetTime();
+
 		while (running)
 		{
-			RunFrame(0.0);
+			RunFrame(GetTime());
 			// std::this_thread::sleep_for(std::chrono::milliseconds(16));
 		}
+
+		if (headless)
+		{
+			double elapsed = GetTime() - loopStart;
+			Flux::Info("Headless run finished: {} frames in {:.3f}s ({:.1f} frames/s)",
+					   frameCount, elapsed, elapsed > 0.0 ? frameCount / elapsed : 0.0);
+		}
 #endif
 
 		OnRelease();
 		SpriteBatchRegistry::Clear();
-		ImGui_ImplRune_Shutdown();
+		if (!headless)
+		{
+			ImGui_ImplRune_Shutdown();
+		}
 	}
 
 	Radium::Vector2i Application::GetSize()
@@ -155,10 +294,98 @@ namespace Radium
 		return &camera;
 	}
 
+	double Application::GetTime()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	}
+
+	float Application::GetDeltaTime()
+	{
+		return deltaTime;
+	}
+
+	float Application::GetInterpolationAlpha()
+	{
+		return interpolationAlpha;
+	}
+
+	void Application::Tick(float dt)
+	{
+		deltaTime = dt;
+
+		// Debug geometry is rebuilt by every tick, only keep the latest one
+		Radium::DebugRenderer::Clear();
+
+		{
+			ZoneScopedN("Physics Tick");
+			b2World_Step(worldId, dt, physicsSubSteps);
+			physicsTaskCount = 0;
+		}
+		{
+			ZoneScopedN("User Tick");
+			this->OnTick(dt);
+			tree.OnTick(dt);
+		}
+		{
+			ZoneScopedN("Script Coroutines");
+			Nodes::Lua::scheduler.Update(dt);
+		}
+
+		if (hotReloadScripts)
+		{
+			ZoneScopedN("Script Hot Reload");
+			Nodes::LuaScript::CheckForChanges();
+		}
+	}
+
+	void Application::RunHeadlessFrame()
+	{
+		// Always advance exactly one tick so headless runs are reproducible
+		// regardless of how fast the host machine is
+		interpolationAlpha = 1.0f;
+		Tick(1.0f / (tickRate > 0.0f ? tickRate : 60.0f));
+
+		{
+			ZoneScopedN("Headless Render");
+			tree.OnRender();
+		}
+
+		Input::LateUpdate();
+		{
+			ZoneScopedN("Script GC");
+			Nodes::Lua::memory.Step();
+		}
+		Nodes::Lua::profiler.EndFrame();
+
+		frameCount++;
+		if (headlessFrames > 0 && frameCount >= headlessFrames)
+		{
+			running = false;
+		}
+	}
+
 	void Application::RunFrame(double time)
 	{
 		ZoneScoped;
 
+		if (headless)
+		{
+			RunHeadlessFrame();
+			return;
+		}
+
+		double frameTime = (lastFrameTime < 0.0) ? 0.0 : time - lastFrameTime;
+		lastFrameTime = time;
+
+		if (frameTime < 0.0)
+		{
+			frameTime = 0.0;
+		}
+		if (frameTime > maxFrameTime)
+		{
+			frameTime = maxFrameTime;
+		}
+
 		{
 			ZoneScopedN("Event Poll");
 
@@ -174,14 +401,37 @@ namespace Radium
 		}
 
 		//Flux::Info("FPS: {:.1f}", ImGui::GetIO().Framerate);
+		if (fixedTimestep && tickRate > 0.0f)
 		{
-			ZoneScopedN("Physics Tick");
-			b2World_Step(worldId, 1.0f / 60.0f, 4);
+			ZoneScopedN("Fixed Update");
+
+			double step = 1.0 / tickRate;
+			accumulator += frameTime;
+
+			int ticks = 0;
+			while (accumulator >= step && ticks < maxTicksPerFrame)
+			{
+				Tick((float)step);
+				accumulator -= step;
+				ticks++;
+			}
+
+			// Too far behind to catch up, drop the backlog instead of spiralling
+			if (accumulator >= step)
+			{
+				accumulator = std::fmod(accumulator, step);
+			}
+
+			interpolationAlpha = (float)(accumulator / step);
 		}
+		else
 		{
-			ZoneScopedN("User Tick");
-			this->OnTick(0);
-			tree.OnTick(0);
+			accumulator = 0.0;
+			interpolationAlpha = 1.0f;
+			if (frameTime > 0.0)
+			{
+				Tick((float)frameTime);
+			}
 		}
 
 		{
@@ -207,9 +457,12 @@ namespace Radium
 		}
 		{
 			ZoneScopedN("Drawing Sprites");
+			RenderQueue::current = &renderQueue;
 			tree.OnRender();
+			renderQueue.Flush();
+			RenderQueue::current = nullptr;
 
-			auto batches = Radium::SpriteBatchRegistry::GetAll();
+			const auto &batches = Radium::SpriteBatchRegistry::GetAll();
 			for (auto batch : batches)
 			{
 				if (!batch)
@@ -238,6 +491,7 @@ namespace Radium
 
 			this->OnImgui();
 			tree.OnImgui();
+			Nodes::Lua::profiler.DrawImgui();
 		}
 
 		{
@@ -249,16 +503,23 @@ namespace Radium
 #endif
 		Radium::DebugRenderer::Draw();
 		Input::LateUpdate();
+		{
+			ZoneScopedN("Script GC");
+			Nodes::Lua::memory.Step();
+		}
+		Nodes::Lua::profiler.EndFrame();
 		{
 			ZoneScopedN("Finish frame");
 			Rune::FinishFrame();
 		}
+
+		frameCount++;
 	}
 
 #ifdef __EMSCRIPTEN__
 	bool RunFrameWrapper(double time, void *userdata)
 	{
-		Radium::currentApplication->RunFrame(time);
+		Radium::currentApplication->RunFrame(time / 1000.0);
 		return true;
 	}
 #endif
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <iostream>
+#include <chrono>
 #include <Radium/Math.hpp>
 #include <Nova/Nova.hpp>
 #include <Radium/Nodes/Tree.hpp>
 #include <box2d/box2d.h>
 #include <Radium/Nodes/Tree.hpp>
 #include <Radium/Camera.hpp>
+#include <Radium/JobSystem.hpp>
+#include <Radium/RenderQueue.hpp>
+#include <memory>
 
 /**
  * @brief Defines the application entry point.
@@ -19,10 +23,11 @@
  */
 #define RADIUM_ENTRYPOINT(appClass) int main(int argc, char* argv[]) { \
     appClass app; \
+    app.ParseArguments(argc, argv); \
     app.OnPreLoad(argc, argv); \
     Radium::currentApplication = &app; \
     app.Run(); \
-    return 0; \
+    return app.GetExitCode(); \
 }
 
 namespace Radium {
@@ -45,6 +50,65 @@ namespace Radium {
         /** @brief The main camera for the application. */
         Radium::Camera camera;
 
+        /** @brief Sorts the sprites of the main render pass before they are submitted. */
+        Radium::RenderQueue renderQueue;
+
+        /**
+         * @brief Whether the simulation runs at a fixed rate, decoupled from rendering.
+         *
+         * When enabled, physics and node ticks run `tickRate` times per second regardless
+         * of the frame rate, and rendering interpolates between the last two ticks.
+         * When disabled, one tick is run per frame using the real frame delta.
+         */
+        bool fixedTimestep = true;
+
+        /** @brief Number of simulation ticks per second when fixedTimestep is enabled. */
+        float tickRate = 60.0f;
+
+        /**
+         * @brief Maximum number of ticks run in a single frame.
+         *
+         * If the simulation falls further behind than this, the remaining time is dropped
+         * so a slow frame cannot snowball into ever longer frames.
+         */
+        int maxTicksPerFrame = 5;
+
+        /** @brief Longest frame delta in seconds that will be fed into the simulation. */
+        float maxFrameTime = 0.25f;
+
+        /** @brief Number of Box2D sub-steps per physics step. */
+        int physicsSubSteps = 4;
+
+        /**
+         * @brief Number of job system worker threads to start, negative uses one per core.
+         * 
+         * Read when Run() starts, 0 runs all jobs on the main thread. The same threads
+         * solve Box2D islands, so this also sets the physics worker count.
+         */
+        int jobThreadCount = -1;
+
+        /**
+         * @brief Run without a window, GPU or ImGui.
+         * 
+         * Only the scene tree and physics are simulated, each frame advances exactly one tick.
+         * Enabled by the `--headless` argument or the `RADIUM_HEADLESS` environment variable.
+         */
+        bool headless = false;
+
+        /**
+         * @brief Number of frames to run in headless mode before stopping, 0 runs until Quit().
+         * 
+         * Set by the `--frames N` argument or the `RADIUM_HEADLESS_FRAMES` environment variable.
+         */
+        int headlessFrames = 0;
+
+        /**
+         * @brief Reload Lua scripts when their files change, keeping the state of the nodes using them.
+         * 
+         * Enabled by the `--hot-reload` argument.
+         */
+        bool hotReloadScripts = false;
+
         /**
          * @brief Returns the window title of the application.
          * @return A string containing the window title.
@@ -111,6 +175,41 @@ namespace Radium {
          */
         virtual void OnPreLoad(int argc, char* argv[]) {}
 
+        /**
+         * @brief Reads engine options such as `--headless` and `--frames N` from the command line.
+         * 
+         * Called by RADIUM_ENTRYPOINT before OnPreLoad. Unknown arguments are ignored.
+         * 
+         * @param argc Argument count.
+         * @param argv Argument values.
+         */
+        void ParseArguments(int argc, char* argv[]);
+
+        /**
+         * @brief Stops the main loop after the current frame.
+         * 
+         * @param exitCode Code returned from main() by RADIUM_ENTRYPOINT.
+         */
+        void Quit(int exitCode = 0);
+
+        /**
+         * @brief Returns the exit code passed to Quit().
+         * @return The exit code, 0 if Quit() was never called.
+         */
+        int GetExitCode();
+
+        /**
+         * @brief Gets the job system used to spread engine work across cores.
+         * @return The job system, or nullptr before Run() has started.
+         */
+        JobSystem* GetJobSystem();
+
+        /**
+         * @brief Returns whether the application is running without a window or GPU.
+         * @return True in headless mode.
+         */
+        bool IsHeadless();
+
         /**
          * @brief Starts the main application loop.
          * 
@@ -133,10 +232,31 @@ namespace Radium {
         /**
          * @brief Processes and renders a single frame of the application.
          * 
-         * @param time The current time (used for animations and delta time).
+         * @param time The current time in seconds (used for animations and delta time).
          */
         void RunFrame(double time);
 
+        /**
+         * @brief Returns the time in seconds since the application was constructed.
+         * @return Monotonic time in seconds.
+         */
+        double GetTime();
+
+        /**
+         * @brief Returns the delta time used by the most recent simulation tick.
+         * @return Tick delta in seconds.
+         */
+        float GetDeltaTime();
+
+        /**
+         * @brief Returns how far rendering is between the previous and current tick.
+         * 
+         * 0 means the previous tick's state, 1 means the latest tick's state. Always 1
+         * when fixedTimestep is disabled.
+         * @return Interpolation factor in the range [0, 1].
+         */
+        float GetInterpolationAlpha();
+
         /**
          * @brief Constructs a new Application object.
          * Initializes internal state.
@@ -149,6 +269,63 @@ namespace Radium {
 
         /** @brief Indicates whether the main loop is still running. */
         bool running = true;
+
+        /** @brief Work-stealing scheduler shared by the engine, created in Run(). */
+        std::unique_ptr<JobSystem> jobSystem;
+
+        /** @brief Exit code set by Quit(). */
+        int exitCode = 0;
+
+        /** @brief Number of frames run so far. */
+        int frameCount = 0;
+
+        /** @brief Time at which the application was constructed. */
+        std::chrono::steady_clock::time_point startTime;
+
+        /** @brief Time passed to the previous RunFrame call, negative before the first frame. */
+        double lastFrameTime = -1.0;
+
+        /** @brief Unsimulated time carried over between frames in fixed timestep mode. */
+        double accumulator = 0.0;
+
+        /** @brief Delta time of the most recent tick. */
+        float deltaTime = 0.0f;
+
+        /** @brief Interpolation factor between the previous and current tick. */
+        float interpolationAlpha = 1.0f;
+
+        /**
+         * @brief Runs one simulation tick: physics step followed by user and node ticks.
+         * 
+         * @param dt Delta time in seconds.
+         */
+        void Tick(float dt);
+
+        /** @brief Job groups handed to Box2D as task handles, reused every step. */
+        std::vector<std::unique_ptr<JobGroup>> physicsTasks;
+
+        /** @brief Number of entries in physicsTasks used by the current step. */
+        size_t physicsTaskCount = 0;
+
+        /**
+         * @brief Box2D enqueueTask callback, runs a physics task on the job system.
+         */
+        static void* EnqueuePhysicsTask(b2TaskCallback* task, int itemCount, int minRange, void* taskContext, void* userContext);
+
+        /**
+         * @brief Box2D finishTask callback, waits for a task from EnqueuePhysicsTask.
+         */
+        static void FinishPhysicsTask(void* userTask, void* userContext);
+
+        /**
+         * @brief Creates the window and initializes Rune, ImGui and the debug renderer.
+         */
+        void InitializeGraphics();
+
+        /**
+         * @brief Runs a frame in headless mode: a single tick and a render pass without GPU submission.
+         */
+        void RunHeadlessFrame();
     };
 
     /** @brief Pointer to the currently running Radium application. */
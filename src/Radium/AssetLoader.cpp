@@ -5,6 +5,17 @@
 #include <sstream>
 #include <algorithm>
 #include <stdexcept>
+#include <filesystem>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace Radium
 {
@@ -36,4 +47,150 @@ namespace Radium
     }
 
 
+    static std::string ExpandAssetPath(const std::string& filename)
+    {
+        std::string expandedFileName = assetBase + filename;
+
+    #ifdef _MSC_VER
+        std::replace(expandedFileName.begin(), expandedFileName.end(), '/', '\\');
+    #endif
+
+        return expandedFileName;
+    }
+
+    bool WriteStringToFile(std::string filename, const std::string& contents, bool external)
+    {
+        std::ofstream file(ExpandAssetPath(filename), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        file.write(contents.data(), (std::streamsize)contents.size());
+        return file.good();
+    }
+
+    bool IsFileUpToDate(std::string filename, std::string source, bool external)
+    {
+        std::error_code error;
+        auto fileTime = std::filesystem::last_write_time(ExpandAssetPath(filename), error);
+        if (error)
+        {
+            return false;
+        }
+
+        auto sourceTime = std::filesystem::last_write_time(ExpandAssetPath(source), error);
+        if (error)
+        {
+            // Nothing to compare against, the file is all there is
+            return true;
+        }
+
+        return fileTime >= sourceTime;
+    }
+
+    std::filesystem::file_time_type GetFileWriteTime(std::string filename, bool external)
+    {
+        std::error_code error;
+        auto writeTime = std::filesystem::last_write_time(ExpandAssetPath(filename), error);
+        if (error)
+        {
+            return std::filesystem::file_time_type::min();
+        }
+
+        return writeTime;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    bool MappedFile::Open(std::string filename, bool external)
+    {
+        Close();
+
+        std::string expandedFileName = ExpandAssetPath(filename);
+
+    #if defined(_WIN32)
+        HANDLE file = CreateFileA(expandedFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            LARGE_INTEGER fileSize;
+            if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+            {
+                HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping)
+                {
+                    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    if (view)
+                    {
+                        fileHandle = file;
+                        mappingHandle = mapping;
+                        data = static_cast<const uint8_t*>(view);
+                        size = (size_t)fileSize.QuadPart;
+                        mapped = true;
+                        return true;
+                    }
+                    CloseHandle(mapping);
+                }
+            }
+            CloseHandle(file);
+        }
+    #elif !defined(__EMSCRIPTEN__)
+        int fd = open(expandedFileName.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            struct stat info;
+            if (fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (view != MAP_FAILED)
+                {
+                    // The mapping stays valid after the descriptor is closed
+                    close(fd);
+                    data = static_cast<const uint8_t*>(view);
+                    size = (size_t)info.st_size;
+                    mapped = true;
+                    return true;
+                }
+            }
+            close(fd);
+        }
+    #endif
+
+        // No mmap here, or mapping failed, read it into memory instead
+        std::ifstream file(expandedFileName, std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            Flux::Error("Failed to open file: {}", expandedFileName);
+            return false;
+        }
+
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (mapped)
+        {
+        #if defined(_WIN32)
+            UnmapViewOfFile(data);
+            CloseHandle((HANDLE)mappingHandle);
+            CloseHandle((HANDLE)fileHandle);
+            mappingHandle = nullptr;
+            fileHandle = nullptr;
+        #elif !defined(__EMSCRIPTEN__)
+            munmap(const_cast<uint8_t*>(data), size);
+        #endif
+        }
+
+        buffer.clear();
+        buffer.shrink_to_fit();
+        data = nullptr;
+        size = 0;
+        mapped = false;
+    }
 }
\ No newline at end of file
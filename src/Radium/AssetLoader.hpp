@@ -1,5 +1,9 @@
 #pragma once
 #include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <filesystem>
 
 namespace Radium {
     /// @brief Base for all assets to be loaded from.
@@ -12,4 +16,77 @@ namespace Radium {
      * @param external Whether the path should have assetBase or not.
      */
     std::string ReadFileToString(std::string filename, bool external = false);
+
+    /**
+     * @brief Write a string to a file in assetfs, replacing it
+     * 
+     * @param filename A path to a file
+     * @param contents Bytes to write
+     * @param external Whether the path should have assetBase or not.
+     * @return true if the whole file was written.
+     */
+    bool WriteStringToFile(std::string filename, const std::string& contents, bool external = false);
+
+    /**
+     * @brief Check whether a file in assetfs exists and is at least as new as another
+     * 
+     * @param filename A path to the file to check, e.g. a baked asset
+     * @param source A path to the file it was produced from
+     * @param external Whether the paths should have assetBase or not.
+     */
+    bool IsFileUpToDate(std::string filename, std::string source, bool external = false);
+
+    /**
+     * @brief Get the last modification time of a file in assetfs
+     * 
+     * @param filename A path to a file
+     * @param external Whether the path should have assetBase or not.
+     * @return The write time, or file_time_type::min() if the file does not exist
+     */
+    std::filesystem::file_time_type GetFileWriteTime(std::string filename, bool external = false);
+
+    /**
+     * @brief A read-only view of a whole file, memory mapped where the platform allows it
+     * 
+     * Falls back to reading the file into memory on platforms without mmap, such as the web.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief Map a file from assetfs
+         * 
+         * @param filename A path to a file
+         * @param external Whether the path should have assetBase or not.
+         * @return true if the file was opened.
+         */
+        bool Open(std::string filename, bool external = false);
+
+        /**
+         * @brief Unmap the file, Data() is invalid afterwards
+         */
+        void Close();
+
+        /// @brief Pointer to the start of the file, nullptr if nothing is open
+        const uint8_t* Data() const { return data; }
+
+        /// @brief Size of the file in bytes
+        size_t Size() const { return size; }
+
+    private:
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        bool mapped = false;
+        /// Backing storage when the file could not be mapped
+        std::vector<uint8_t> buffer;
+    #ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+    #endif
+    };
 }
\ No newline at end of file
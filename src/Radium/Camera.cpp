@@ -22,4 +22,17 @@ namespace Radium {
         );
     }
 
+    RectangleF Camera::GetVisibleArea(float screenWidth, float screenHeight, float pixelScale) const {
+        float width = screenWidth / pixelScale;
+        float height = screenHeight / pixelScale;
+
+        // World y points up on screen, and centered sprites are shifted by half the screen
+        return RectangleF(
+            offset.x - width / 2.0f,
+            offset.y - height,
+            width * 1.5f,
+            height * 1.5f
+        );
+    }
+
 } // namespace Radium
@@ -39,6 +39,18 @@ namespace Radium {
          */
         RectangleF GetViewport(float screenWidth, float screenHeight) const;
 
+        /**
+         * @brief Gets the world area sprites can appear in, for culling.
+         *
+         * Covers the screen for sprites drawn from either the top-left or the center origin,
+         * so it is slightly larger than what is actually visible.
+         * @param screenWidth The width of the screen/viewport in pixels.
+         * @param screenHeight The height of the screen/viewport in pixels.
+         * @param pixelScale Pixels per world unit.
+         * @return A RectangleF whose x and y are the minimum corner in world space.
+         */
+        RectangleF GetVisibleArea(float screenWidth, float screenHeight, float pixelScale) const;
+
         Vector2f offset; ///< The camera's offset from the origin
     private:
         
@@ -867,7 +867,9 @@ namespace Radium::DebugRenderer {
     void Draw() {
         renderer->SetVertices(vertices);
         renderer->Draw();
+    }
 
+    void Clear() {
         vertices.clear();
     }
 };
\ No newline at end of file
@@ -25,5 +25,9 @@ namespace Radium::DebugRenderer {
 
     void AddString(std::string s, Vector2f pos, float r, float g, float b, float thickness = 5);
 
+    /// @brief Draw the queued geometry. The queue is kept until Clear() so frames without a tick still show it.
     void Draw();
+
+    /// @brief Discard all queued geometry, called by Application before every tick.
+    void Clear();
 }
\ No newline at end of file
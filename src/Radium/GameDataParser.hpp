@@ -21,6 +21,17 @@ namespace Radium {
         std::vector<int> gravity;
         std::string initialScene;
         std::vector<SpriteBatch> spriteBatches;
+        float tickRate = 60.0f;
+        int jobThreads = -1;
+        bool cullSprites = false;
+        bool packAtlas = false;
+        int atlasPageSize = 2048;
+        bool compiledScriptCache = false;
+        float scriptBudgetMs = 0.0f;
+        std::string scriptGc = "incremental";
+        int scriptGcStepKb = 64;
+        int scriptMemoryLimitKb = 0;
+        int scriptMemoryTotalLimitKb = 0;
     };
 
     // Serialization for SpriteOrigin
@@ -59,7 +70,18 @@ namespace Radium {
             {"preferedSize", config.preferedSize},
             {"gravity", config.gravity},
             {"initialScene", config.initialScene},
-            {"spriteBatches", config.spriteBatches}
+            {"spriteBatches", config.spriteBatches},
+            {"tickRate", config.tickRate},
+            {"jobThreads", config.jobThreads},
+            {"cullSprites", config.cullSprites},
+            {"packAtlas", config.packAtlas},
+            {"atlasPageSize", config.atlasPageSize},
+            {"compiledScriptCache", config.compiledScriptCache},
+            {"scriptBudgetMs", config.scriptBudgetMs},
+            {"scriptGc", config.scriptGc},
+            {"scriptGcStepKb", config.scriptGcStepKb},
+            {"scriptMemoryLimitKb", config.scriptMemoryLimitKb},
+            {"scriptMemoryTotalLimitKb", config.scriptMemoryTotalLimitKb}
         };
     }
 
@@ -69,5 +91,16 @@ namespace Radium {
         j.at("gravity").get_to(config.gravity);
         j.at("initialScene").get_to(config.initialScene);
         j.at("spriteBatches").get_to(config.spriteBatches);
+        config.tickRate = j.value("tickRate", 60.0f);
+        config.jobThreads = j.value("jobThreads", -1);
+        config.cullSprites = j.value("cullSprites", false);
+        config.packAtlas = j.value("packAtlas", false);
+        config.atlasPageSize = j.value("atlasPageSize", 2048);
+        config.compiledScriptCache = j.value("compiledScriptCache", false);
+        config.scriptBudgetMs = j.value("scriptBudgetMs", 0.0f);
+        config.scriptGc = j.value("scriptGc", std::string("incremental"));
+        config.scriptGcStepKb = j.value("scriptGcStepKb", 64);
+        config.scriptMemoryLimitKb = j.value("scriptMemoryLimitKb", 0);
+        config.scriptMemoryTotalLimitKb = j.value("scriptMemoryTotalLimitKb", 0);
     }
 };
\ No newline at end of file
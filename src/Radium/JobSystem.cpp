@@ -0,0 +1,186 @@
+#include <Radium/JobSystem.hpp>
+#include <tracy/Tracy.hpp>
+#include <Flux/Flux.hpp>
+#include <algorithm>
+
+namespace Radium {
+    // Which JobSystem and worker slot the current thread belongs to
+    static thread_local const JobSystem* currentSystem = nullptr;
+    static thread_local unsigned int currentIndex = 0;
+
+    JobSystem::JobSystem(int threadCount) {
+        if (threadCount < 0) {
+            unsigned int cores = std::thread::hardware_concurrency();
+            threadCount = cores > 1 ? (int)cores - 1 : 0;
+        }
+
+        // Slot 0 belongs to the constructing thread
+        for (int i = 0; i <= threadCount; i++) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+
+        currentSystem = this;
+        currentIndex = 0;
+
+        for (int i = 1; i <= threadCount; i++) {
+            threads.emplace_back(&JobSystem::WorkerLoop, this, (unsigned int)i);
+        }
+
+        Flux::Info("Started job system with {} worker threads", threadCount);
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        sleepCondition.notify_all();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (currentSystem == this) {
+            currentSystem = nullptr;
+        }
+    }
+
+    unsigned int JobSystem::GetThreadCount() const {
+        return (unsigned int)workers.size();
+    }
+
+    unsigned int JobSystem::GetCurrentWorkerIndex() const {
+        return currentSystem == this ? currentIndex : 0;
+    }
+
+    void JobSystem::Run(JobGroup& group, std::function<void()> job) {
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+
+        if (threads.empty()) {
+            job();
+            group.pending.fetch_sub(1, std::memory_order_release);
+            return;
+        }
+
+        Worker& worker = *workers[GetCurrentWorkerIndex()];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.queue.push_back({std::move(job), &group});
+        }
+
+        queuedJobs.fetch_add(1, std::memory_order_release);
+        {
+            // Taking the lock orders the notify after a sleeping worker's predicate check
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        sleepCondition.notify_one();
+    }
+
+    void JobSystem::Wait(JobGroup& group) {
+        unsigned int index = GetCurrentWorkerIndex();
+
+        while (group.pending.load(std::memory_order_acquire) > 0) {
+            if (!TryRunJob(index)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& fn) {
+        if (count == 0) {
+            return;
+        }
+
+        grainSize = std::max<size_t>(grainSize, 1);
+
+        // A few ranges per thread leaves room for stealing when items are uneven
+        size_t targetRanges = (size_t)GetThreadCount() * 4;
+        size_t rangeSize = std::max(grainSize, (count + targetRanges - 1) / targetRanges);
+
+        if (threads.empty() || rangeSize >= count) {
+            fn(0, count);
+            return;
+        }
+
+        JobGroup group;
+        for (size_t begin = rangeSize; begin < count; begin += rangeSize) {
+            size_t end = std::min(begin + rangeSize, count);
+            Run(group, [&fn, begin, end]() { fn(begin, end); });
+        }
+
+        // The caller takes the first range itself instead of waiting idle
+        fn(0, std::min(rangeSize, count));
+
+        Wait(group);
+    }
+
+    bool JobSystem::PopLocal(unsigned int index, Job& job) {
+        Worker& worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+
+        if (worker.queue.empty()) {
+            return false;
+        }
+
+        // Newest first, it is most likely still in cache
+        job = std::move(worker.queue.back());
+        worker.queue.pop_back();
+        return true;
+    }
+
+    bool JobSystem::Steal(unsigned int index, Job& job) {
+        size_t count = workers.size();
+
+        for (size_t offset = 1; offset < count; offset++) {
+            Worker& victim = *workers[(index + offset) % count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+
+            if (victim.queue.empty()) {
+                continue;
+            }
+
+            // Oldest first, it is usually the largest remaining piece of work
+            job = std::move(victim.queue.front());
+            victim.queue.pop_front();
+            return true;
+        }
+
+        return false;
+    }
+
+    bool JobSystem::TryRunJob(unsigned int index) {
+        Job job;
+        if (!PopLocal(index, job) && !Steal(index, job)) {
+            return false;
+        }
+
+        queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+
+        {
+            ZoneScopedN("Job");
+            job.fn();
+        }
+        job.group->pending.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    void JobSystem::WorkerLoop(unsigned int index) {
+        currentSystem = this;
+        currentIndex = index;
+
+        while (true) {
+            if (TryRunJob(index)) {
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleepCondition.wait(lock, [this]() {
+                return stopping.load() || queuedJobs.load(std::memory_order_acquire) > 0;
+            });
+
+            if (stopping) {
+                return;
+            }
+        }
+    }
+}
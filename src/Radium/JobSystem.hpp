@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Radium {
+
+    /**
+     * @brief Tracks a set of jobs so they can be waited on together.
+     *
+     * Pass the same group to several JobSystem::Run calls, then JobSystem::Wait
+     * on it to join them.
+     */
+    struct JobGroup {
+        /// Number of jobs in the group that have not finished yet.
+        std::atomic<int> pending{0};
+    };
+
+    /**
+     * @brief A work-stealing job scheduler.
+     *
+     * Every worker thread owns a queue. Workers take their own newest job first and,
+     * when they run dry, steal the oldest job from another worker. The thread that
+     * constructs the JobSystem counts as worker 0 and helps execute jobs while it waits,
+     * so fork/join from the main thread never blocks idle.
+     */
+    class JobSystem {
+    public:
+        /**
+         * @brief Start the worker threads.
+         *
+         * @param threadCount Number of extra threads to spawn. Negative uses one per core,
+         * minus the calling thread. 0 runs every job inline on the calling thread.
+         */
+        explicit JobSystem(int threadCount = -1);
+
+        /**
+         * @brief Stops and joins all worker threads.
+         */
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /**
+         * @brief Get the number of threads executing jobs, including the calling thread.
+         */
+        unsigned int GetThreadCount() const;
+
+        /**
+         * @brief Get the worker slot of the calling thread, in [0, GetThreadCount()).
+         *
+         * Threads that do not belong to this system share slot 0 with the constructing thread.
+         */
+        unsigned int GetCurrentWorkerIndex() const;
+
+        /**
+         * @brief Queue a job as part of a group.
+         *
+         * @param group Group to add the job to.
+         * @param job Function to run on any worker.
+         */
+        void Run(JobGroup& group, std::function<void()> job);
+
+        /**
+         * @brief Block until every job in the group has finished.
+         *
+         * The calling thread executes queued jobs while it waits.
+         *
+         * @param group Group to wait for.
+         */
+        void Wait(JobGroup& group);
+
+        /**
+         * @brief Run a function over [0, count) split into ranges, and wait for all of them.
+         *
+         * @param count Number of items.
+         * @param grainSize Minimum items per range, ranges are never smaller than this.
+         * @param fn Called with each half-open range [begin, end).
+         */
+        void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& fn);
+
+    private:
+        struct Job {
+            std::function<void()> fn;
+            JobGroup* group;
+        };
+
+        struct Worker {
+            std::mutex mutex;
+            std::deque<Job> queue;
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        std::atomic<int> queuedJobs{0};
+        std::atomic<bool> stopping{false};
+
+        void WorkerLoop(unsigned int index);
+        bool TryRunJob(unsigned int index);
+        bool PopLocal(unsigned int index, Job& job);
+        bool Steal(unsigned int index, Job& job);
+    };
+}
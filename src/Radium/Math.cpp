@@ -289,6 +289,16 @@ namespace Radium
             a.y + a.h > b.y);
     }
 
+    // Read an operand of a Lua metamethod or method as a value type
+    template <typename T>
+    static T check_value(lua_State* L, int index, const char* name) {
+        T* value = Nodes::classdb_lua_to<T>(L, index);
+        if (!value) {
+            luaL_error(L, "Expected %s at argument %d", name, index);
+        }
+        return *value;
+    }
+
     void Vector2f::Register() {
         CLASSDB_REGISTER(Vector2f);
         CLASSDB_DECLARE_PROPERTY(Vector2f, float, x);
@@ -297,7 +307,7 @@ namespace Radium
         LUA_CONSTRUCTOR("Vector2f", [](lua_State* L) -> int {
             float x = Nodes::get_float_arg(L, 1);
             float y = Nodes::get_float_arg(L, 2);
-            return Radium::Nodes::classdb_lua_wrap(L, new Vector2f(x, y));
+            return Radium::Nodes::classdb_lua_push_value(L, Vector2f(x, y));
         });
 
         LUA_FUNC("Radium::Vector2f::Length", [](lua_State* L) -> int {
@@ -314,14 +324,48 @@ namespace Radium
 
         LUA_FUNC("Radium::Vector2f::Normalize", [](lua_State* L) -> int {
             Vector2f* instance = (Vector2f*)lua_touserdata(L, lua_upvalueindex(1));
-            Vector2f result = instance->Normalize();
-            return Radium::Nodes::classdb_lua_wrap(L, new Vector2f(result));
+            return Radium::Nodes::classdb_lua_push_value(L, instance->Normalize());
         });
 
         LUA_FUNC("Radium::Vector2f::Dot", [](lua_State* L) -> int {
             Vector2f* instance = (Vector2f*)lua_touserdata(L, lua_upvalueindex(1));
-            Vector2f* other = (Vector2f*)lua_touserdata(L, 1);
-            lua_pushnumber(L, instance->Dot(*other));
+            Vector2f other = check_value<Vector2f>(L, 2, "Vector2f");
+            lua_pushnumber(L, instance->Dot(other));
+            return 1;
+        });
+
+        LUA_FUNC("Radium::Vector2f::__add", [](lua_State* L) -> int {
+            return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2f>(L, 1, "Vector2f") + check_value<Vector2f>(L, 2, "Vector2f"));
+        });
+
+        LUA_FUNC("Radium::Vector2f::__sub", [](lua_State* L) -> int {
+            return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2f>(L, 1, "Vector2f") - check_value<Vector2f>(L, 2, "Vector2f"));
+        });
+
+        LUA_FUNC("Radium::Vector2f::__mul", [](lua_State* L) -> int {
+            // Scalar on either side
+            if (lua_isnumber(L, 1)) {
+                return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2f>(L, 2, "Vector2f") * (float)lua_tonumber(L, 1));
+            }
+            return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2f>(L, 1, "Vector2f") * Nodes::get_float_arg(L, 2));
+        });
+
+        LUA_FUNC("Radium::Vector2f::__div", [](lua_State* L) -> int {
+            return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2f>(L, 1, "Vector2f") / Nodes::get_float_arg(L, 2));
+        });
+
+        LUA_FUNC("Radium::Vector2f::__unm", [](lua_State* L) -> int {
+            return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2f>(L, 1, "Vector2f") * -1.0f);
+        });
+
+        LUA_FUNC("Radium::Vector2f::__eq", [](lua_State* L) -> int {
+            lua_pushboolean(L, check_value<Vector2f>(L, 1, "Vector2f") == check_value<Vector2f>(L, 2, "Vector2f"));
+            return 1;
+        });
+
+        LUA_FUNC("Radium::Vector2f::__tostring", [](lua_State* L) -> int {
+            Vector2f value = check_value<Vector2f>(L, 1, "Vector2f");
+            lua_pushfstring(L, "Vector2f(%f, %f)", (double)value.x, (double)value.y);
             return 1;
         });
 
@@ -335,7 +379,7 @@ namespace Radium
         LUA_CONSTRUCTOR("Vector2i", [](lua_State* L) -> int {
             int x = Nodes::get_float_arg(L, 1);
             int y = Nodes::get_float_arg(L, 2);
-            return Radium::Nodes::classdb_lua_wrap(L, new Vector2i(x, y));
+            return Radium::Nodes::classdb_lua_push_value(L, Vector2i(x, y));
         });
 
         LUA_FUNC("Radium::Vector2i::LengthSquared", [](lua_State* L) -> int {
@@ -346,8 +390,49 @@ namespace Radium
 
         LUA_FUNC("Radium::Vector2i::Dot", [](lua_State* L) -> int {
             Vector2i* instance = (Vector2i*)lua_touserdata(L, lua_upvalueindex(1));
-            Vector2i* other = (Vector2i*)lua_touserdata(L, 1);
-            lua_pushinteger(L, instance->Dot(*other));
+            Vector2i other = check_value<Vector2i>(L, 2, "Vector2i");
+            lua_pushinteger(L, instance->Dot(other));
+            return 1;
+        });
+
+        LUA_FUNC("Radium::Vector2i::__add", [](lua_State* L) -> int {
+            return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2i>(L, 1, "Vector2i") + check_value<Vector2i>(L, 2, "Vector2i"));
+        });
+
+        LUA_FUNC("Radium::Vector2i::__sub", [](lua_State* L) -> int {
+            return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2i>(L, 1, "Vector2i") - check_value<Vector2i>(L, 2, "Vector2i"));
+        });
+
+        LUA_FUNC("Radium::Vector2i::__mul", [](lua_State* L) -> int {
+            if (lua_isinteger(L, 1)) {
+                return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2i>(L, 2, "Vector2i") * (int)lua_tointeger(L, 1));
+            }
+            return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2i>(L, 1, "Vector2i") * (int)luaL_checkinteger(L, 2));
+        });
+
+        // Integer division either way, like Vector2i::operator/
+        lua_CFunction divide = [](lua_State* L) -> int {
+            int scalar = (int)luaL_checkinteger(L, 2);
+            if (scalar == 0) {
+                return luaL_error(L, "Division by zero");
+            }
+            return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2i>(L, 1, "Vector2i") / scalar);
+        };
+        LUA_FUNC("Radium::Vector2i::__div", divide);
+        LUA_FUNC("Radium::Vector2i::__idiv", divide);
+
+        LUA_FUNC("Radium::Vector2i::__unm", [](lua_State* L) -> int {
+            return Radium::Nodes::classdb_lua_push_value(L, check_value<Vector2i>(L, 1, "Vector2i") * -1);
+        });
+
+        LUA_FUNC("Radium::Vector2i::__eq", [](lua_State* L) -> int {
+            lua_pushboolean(L, check_value<Vector2i>(L, 1, "Vector2i") == check_value<Vector2i>(L, 2, "Vector2i"));
+            return 1;
+        });
+
+        LUA_FUNC("Radium::Vector2i::__tostring", [](lua_State* L) -> int {
+            Vector2i value = check_value<Vector2i>(L, 1, "Vector2i");
+            lua_pushfstring(L, "Vector2i(%d, %d)", value.x, value.y);
             return 1;
         });
 
@@ -366,7 +451,13 @@ namespace Radium
             float w = Nodes::get_float_arg(L, 3);
             float h = Nodes::get_float_arg(L, 4);
 
-            return Radium::Nodes::classdb_lua_wrap(L, new RectangleF(x, y, w, h));
+            return Radium::Nodes::classdb_lua_push_value(L, RectangleF(x, y, w, h));
+        });
+
+        LUA_FUNC("Radium::RectangleF::__tostring", [](lua_State* L) -> int {
+            RectangleF value = check_value<RectangleF>(L, 1, "RectangleF");
+            lua_pushfstring(L, "RectangleF(%f, %f, %f, %f)", (double)value.x, (double)value.y, (double)value.w, (double)value.h);
+            return 1;
         });
     }
 
@@ -0,0 +1,167 @@
+#include <Radium/Nodes/2D/BodyGroup.hpp>
+#include <Radium/Nodes/2D/RigidBody.hpp>
+#include <Radium/Nodes/LuaScript.hpp>
+#include <algorithm>
+
+namespace Radium::Nodes
+{
+    b2BodyId *BodyGroup::GetIds()
+    {
+        return reinterpret_cast<b2BodyId *>(this + 1);
+    }
+
+    static BodyGroup *check_group(lua_State *L)
+    {
+        return static_cast<BodyGroup *>(luaL_checkudata(L, 1, "BodyGroup"));
+    }
+
+    // Calls fn with every valid body and its vector from argument 2, either a flat array or two numbers
+    template <typename Fn>
+    static int for_each_vector(lua_State *L, Fn fn)
+    {
+        BodyGroup *group = check_group(L);
+        b2BodyId *ids = group->GetIds();
+
+        if (!lua_istable(L, 2))
+        {
+            b2Vec2 value = {(float)luaL_checknumber(L, 2), (float)luaL_checknumber(L, 3)};
+            for (size_t i = 0; i < group->count; i++)
+            {
+                if (b2Body_IsValid(ids[i]))
+                {
+                    fn(ids[i], value);
+                }
+            }
+            return 0;
+        }
+
+        size_t count = std::min(group->count, (size_t)lua_rawlen(L, 2) / 2);
+        for (size_t i = 0; i < count; i++)
+        {
+            lua_rawgeti(L, 2, (lua_Integer)(i * 2 + 1));
+            lua_rawgeti(L, 2, (lua_Integer)(i * 2 + 2));
+            b2Vec2 value = {(float)lua_tonumber(L, -2), (float)lua_tonumber(L, -1)};
+            lua_pop(L, 2);
+
+            if (b2Body_IsValid(ids[i]))
+            {
+                fn(ids[i], value);
+            }
+        }
+        return 0;
+    }
+
+    // Writes a vector per body into argument 2, or a new table, and returns it
+    template <typename Fn>
+    static int fill_vectors(lua_State *L, Fn fn)
+    {
+        BodyGroup *group = check_group(L);
+        b2BodyId *ids = group->GetIds();
+
+        if (lua_istable(L, 2))
+        {
+            lua_settop(L, 2);
+        }
+        else
+        {
+            lua_createtable(L, (int)(group->count * 2), 0);
+        }
+
+        for (size_t i = 0; i < group->count; i++)
+        {
+            // Destroyed bodies read as zero so the indices keep lining up
+            b2Vec2 value = b2Body_IsValid(ids[i]) ? fn(ids[i]) : b2Vec2{0.0f, 0.0f};
+
+            lua_pushnumber(L, value.x);
+            lua_rawseti(L, -2, (lua_Integer)(i * 2 + 1));
+            lua_pushnumber(L, value.y);
+            lua_rawseti(L, -2, (lua_Integer)(i * 2 + 2));
+        }
+        return 1;
+    }
+
+    static int lua_group_new(lua_State *L)
+    {
+        luaL_checktype(L, 1, LUA_TTABLE);
+        size_t count = lua_rawlen(L, 1);
+
+        auto *group = static_cast<BodyGroup *>(lua_newuserdatauv(L, sizeof(BodyGroup) + count * sizeof(b2BodyId), 0));
+        group->count = count;
+        b2BodyId *ids = group->GetIds();
+
+        for (size_t i = 0; i < count; i++)
+        {
+            lua_rawgeti(L, 1, (lua_Integer)(i + 1));
+            RigidBody *body = classdb_lua_to<RigidBody>(L, -1);
+            lua_pop(L, 1);
+
+            if (!body)
+            {
+                return luaL_error(L, "Physics.Group: element %d is not a RigidBody", (int)(i + 1));
+            }
+            ids[i] = body->GetBodyId();
+        }
+
+        luaL_setmetatable(L, "BodyGroup");
+        return 1;
+    }
+
+    static int lua_group_apply_forces(lua_State *L)
+    {
+        return for_each_vector(L, [](b2BodyId id, b2Vec2 force)
+                               { b2Body_ApplyForceToCenter(id, force, true); });
+    }
+
+    static int lua_group_apply_impulses(lua_State *L)
+    {
+        return for_each_vector(L, [](b2BodyId id, b2Vec2 impulse)
+                               { b2Body_ApplyLinearImpulseToCenter(id, impulse, true); });
+    }
+
+    static int lua_group_set_linear_velocities(lua_State *L)
+    {
+        return for_each_vector(L, [](b2BodyId id, b2Vec2 velocity)
+                               { b2Body_SetLinearVelocity(id, velocity); });
+    }
+
+    static int lua_group_get_positions(lua_State *L)
+    {
+        return fill_vectors(L, [](b2BodyId id)
+                            { return b2Body_GetPosition(id); });
+    }
+
+    static int lua_group_get_linear_velocities(lua_State *L)
+    {
+        return fill_vectors(L, [](b2BodyId id)
+                            { return b2Body_GetLinearVelocity(id); });
+    }
+
+    static int lua_group_len(lua_State *L)
+    {
+        lua_pushinteger(L, (lua_Integer)check_group(L)->count);
+        return 1;
+    }
+
+    void BodyGroup::RegisterGlobals(lua_State *L)
+    {
+        static const luaL_Reg methods[] = {
+            {"ApplyForces", lua_group_apply_forces},
+            {"ApplyImpulses", lua_group_apply_impulses},
+            {"SetLinearVelocities", lua_group_set_linear_velocities},
+            {"GetPositions", lua_group_get_positions},
+            {"GetLinearVelocities", lua_group_get_linear_velocities},
+            {nullptr, nullptr}};
+
+        luaL_newmetatable(L, "BodyGroup");
+        luaL_newlib(L, methods);
+        lua_setfield(L, -2, "__index");
+        lua_pushcfunction(L, lua_group_len);
+        lua_setfield(L, -2, "__len");
+        lua_pop(L, 1);
+
+        lua_newtable(L);
+        lua_pushcfunction(L, lua_group_new);
+        lua_setfield(L, -2, "Group");
+        lua_setglobal(L, "Physics");
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <box2d/box2d.h>
+
+extern "C" {
+#include <lua.h>
+}
+
+namespace Radium::Nodes {
+
+    /**
+     * @struct BodyGroup
+     * @brief A fixed set of physics bodies that scripts drive with one call per operation.
+     *
+     * Created from Lua with `Physics.Group(bodies)`, where bodies is an array of RigidBody nodes.
+     * Its methods take and fill flat arrays `{x1, y1, x2, y2, ...}` in the order of that array,
+     * so a script steering a swarm crosses into C++ once per operation instead of once per body:
+     *
+     * - `group:ApplyForces(values)` / `group:ApplyImpulses(values)`
+     * - `group:SetLinearVelocities(values)`
+     * - `group:GetPositions(out)` / `group:GetLinearVelocities(out)`, fill and return `out`,
+     *   a new table when omitted
+     *
+     * Instead of an array, the setters also take two numbers applied to every body.
+     * Bodies are stored as Box2D ids, which are validated before each use, so bodies destroyed
+     * since the group was made are skipped. Build groups once the bodies are loaded.
+     */
+    struct BodyGroup {
+        /// Number of bodies, their ids follow the struct in the same userdata.
+        size_t count;
+
+        /**
+         * @brief Get the ids of the bodies in the group.
+         */
+        b2BodyId* GetIds();
+
+        /**
+         * @brief Registers the Physics table and the BodyGroup metatable into a state's globals.
+         */
+        static void RegisterGlobals(lua_State* L);
+    };
+
+}
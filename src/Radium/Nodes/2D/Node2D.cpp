@@ -2,6 +2,7 @@
 #include <Radium/Nodes/LuaScript.hpp>
 #include <Flux/Flux.hpp>
 #include "Node2D.hpp"
+#include <cmath>
 
 namespace Radium::Nodes {
     Node2D::Node2D() {
@@ -22,14 +23,27 @@ namespace Radium::Nodes {
             
             instance->UpdateGlobals();
 
+            return 0; });
+
+        LUA_FUNC("Radium::Nodes::Node2D::ResetInterpolation", [](lua_State *L) -> int
+                 {
+            Node2D* instance = (Node2D*)lua_touserdata(L, lua_upvalueindex(1));
+            
+            // Snap the children too, so a teleported group doesn't smear them
+            instance->UpdateTransforms();
+
             return 0; });
     }
 
     void Node2D::OnLoad() {
+        UpdateGlobals();
+        ResetInterpolation();
         Node::OnLoad();
     }
 
     void Node2D::OnTick(float dt) {
+        previousGlobalPosition = globalPosition;
+        previousGlobalRotation = globalRotation;
         UpdateGlobals();
         Node::OnTick(dt);
     }
@@ -55,13 +69,8 @@ namespace Radium::Nodes {
     }
 
     void Node2D::SetGlobalPosition(Radium::Vector2f val) {
-        if (parent) {
-            Node2D* parent2D = dynamic_cast<Node2D*>(parent);
-            if (parent2D) {
-                position = val - parent2D->globalPosition;
-            } else {
-                position = val;
-            }
+        if (GetParent2D()) {
+            position = val - parent2D->globalPosition;
         } else {
             position = val;
         }
@@ -89,22 +98,69 @@ namespace Radium::Nodes {
     }
 
 
-    void Node2D::UpdateGlobals() {
-        if (parent) {
-            Node2D* parent2D = dynamic_cast<Node2D*>(parent);
-            if (parent2D) {
-                UpdateGlobalPositionInternal(parent2D->globalPosition);
-                UpdateGlobalSizeInternal(parent2D->globalSize);
-                UpdateGlobalRotationInternal(parent2D->globalRotation);
-            } else {
-                UpdateGlobalPositionInternal({0,0});
-                UpdateGlobalSizeInternal({1,1});
-                UpdateGlobalRotationInternal(0);
-            }
+    Node2D* Node2D::GetParent2D() {
+        if (parent != cachedParent) {
+            cachedParent = parent;
+            parent2D = dynamic_cast<Node2D*>(parent);
+            transformDirty = true;
+        }
+        return parent2D;
+    }
+
+    bool Node2D::UpdateGlobals() {
+        GetParent2D();
+
+        bool changed = transformDirty
+            || position != cachedPosition
+            || size != cachedSize
+            || rotation != cachedRotation
+            || (parent2D && parent2D->transformVersion != parentTransformVersion);
+
+        if (!changed) {
+            return false;
+        }
+
+        if (parent2D) {
+            UpdateGlobalPositionInternal(parent2D->globalPosition);
+            UpdateGlobalSizeInternal(parent2D->globalSize);
+            UpdateGlobalRotationInternal(parent2D->globalRotation);
+            parentTransformVersion = parent2D->transformVersion;
         } else {
             UpdateGlobalPositionInternal({0,0});
             UpdateGlobalSizeInternal({1,1});
             UpdateGlobalRotationInternal(0);
         }
+
+        cachedPosition = position;
+        cachedSize = size;
+        cachedRotation = rotation;
+        transformDirty = false;
+        transformVersion++;
+        return true;
+    }
+
+    void Node2D::MarkTransformDirty() {
+        transformDirty = true;
+    }
+
+    void Node2D::UpdateTransforms() {
+        UpdateGlobals();
+        ResetInterpolation();
+        Node::UpdateTransforms();
+    }
+
+    void Node2D::ResetInterpolation() {
+        previousGlobalPosition = globalPosition;
+        previousGlobalRotation = globalRotation;
+    }
+
+    Radium::Vector2f Node2D::GetInterpolatedGlobalPosition(float alpha) {
+        return previousGlobalPosition + (globalPosition - previousGlobalPosition) * alpha;
+    }
+
+    float Node2D::GetInterpolatedGlobalRotation(float alpha) {
+        // Take the shortest way around so a wrap from 180 to -180 doesn't spin the sprite
+        float delta = std::remainder(globalRotation - previousGlobalRotation, 360.0f);
+        return previousGlobalRotation + delta * alpha;
     }
 }
\ No newline at end of file
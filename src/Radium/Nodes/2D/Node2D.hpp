@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <cstdint>
 #include <Radium/Nodes/ClassDB.hpp>
 #include <Radium/Nodes/Node.hpp>
 #include <Radium/Math.hpp>
@@ -47,6 +48,12 @@ namespace Radium::Nodes {
         /// Global rotation of the node in degrees (computed based on parent nodes)
         float globalRotation = 0;
 
+        /// Global position at the previous tick, used to interpolate rendering between ticks.
+        Radium::Vector2f previousGlobalPosition = {0, 0};
+
+        /// Global rotation at the previous tick, used to interpolate rendering between ticks.
+        float previousGlobalRotation = 0;
+
         /**
          * @brief Called when the node is loaded.
          * 
@@ -117,10 +124,84 @@ namespace Radium::Nodes {
 
         /**
          * @brief Update the global position based on the current local position and parent's global position.
+         * 
+         * Only recomputes when the local transform, the parent or the parent's globals changed
+         * since the last update, so unmoved nodes cost a few comparisons.
+         * 
+         * @return true if the globals were recomputed.
+         */
+        bool UpdateGlobals();
+
+        /**
+         * @brief Force the globals to be recomputed on the next UpdateGlobals().
+         * 
+         * Changes to position, size, rotation and parent are noticed on their own. This is
+         * only needed after writing the global values by hand.
+         */
+        void MarkTransformDirty();
+
+        /**
+         * @brief Update this node's globals, snap its interpolation, then do the same for its children.
+         */
+        void UpdateTransforms() override;
+
+        /**
+         * @brief Snap the previous tick transform to the current one.
+         * 
+         * Call after teleporting a node so rendering does not interpolate across the jump.
+         */
+        void ResetInterpolation();
+
+        /**
+         * @brief Get the global position to render at, interpolated between the last two ticks.
+         * 
+         * @param alpha Interpolation factor, 0 is the previous tick and 1 the current tick.
+         * @return Radium::Vector2f The interpolated global position.
+         */
+        Radium::Vector2f GetInterpolatedGlobalPosition(float alpha);
+
+        /**
+         * @brief Get the global rotation to render at, interpolated between the last two ticks.
+         * 
+         * @param alpha Interpolation factor, 0 is the previous tick and 1 the current tick.
+         * @return float The interpolated global rotation in degrees.
          */
-        void UpdateGlobals();
+        float GetInterpolatedGlobalRotation(float alpha);
 
     private:
+        friend class SpriteGrid;
+
+        /// Parent as a Node2D, cached so updates don't dynamic_cast every tick
+        Node2D* parent2D = nullptr;
+
+        /// Parent pointer that parent2D was resolved from
+        Node* cachedParent = nullptr;
+
+        /// Local position the globals were last computed from
+        Radium::Vector2f cachedPosition = {0, 0};
+
+        /// Local size the globals were last computed from
+        Radium::Vector2f cachedSize = {0, 0};
+
+        /// Local rotation the globals were last computed from
+        float cachedRotation = 0;
+
+        /// Incremented every time the globals are recomputed, children compare against it
+        uint32_t transformVersion = 0;
+
+        /// Parent transformVersion the globals were last computed against
+        uint32_t parentTransformVersion = 0;
+
+        /// Set when the globals must be recomputed regardless of the cached values
+        bool transformDirty = true;
+
+        /**
+         * @brief Get the parent as a Node2D, refreshing the cached cast when the parent changed.
+         * 
+         * @return Node2D* The parent, or nullptr if there is none or it is not a Node2D.
+         */
+        Node2D* GetParent2D();
+
         /**
          * @brief Internal recursive method to update global position.
          * 
@@ -98,9 +98,7 @@ namespace Radium::Nodes
         LUA_FUNC("Radium::Nodes::RigidBody::GetLinearVelocity", [](lua_State *L) -> int
                  {
             RigidBody* instance = (RigidBody*)lua_touserdata(L, lua_upvalueindex(1));
-            Radium::Vector2f velocity = instance->GetLinearVelocity();
-            
-            return classdb_lua_wrap(L, &velocity); });
+            return classdb_lua_push_value(L, instance->GetLinearVelocity()); });
 
         LUA_FUNC("Radium::Nodes::RigidBody::SetAngularVelocity", [](lua_State *L) -> int
                  {
@@ -186,7 +184,7 @@ namespace Radium::Nodes
                 }
                 // For static/kinematic bodies, sync from node to Box2D
                 b2Vec2 pos = ToB2Vec2(globalPosition);
-                b2Body_SetTargetTransform(bodyId, {pos, b2Rot_identity}, 1.0f / 60.0f);
+                b2Body_SetTargetTransform(bodyId, {pos, b2Rot_identity}, dt);
             }
             
             // Debug render the collision shape
@@ -222,9 +220,15 @@ namespace Radium::Nodes
         Node2D::OnTick(dt);
     }
 
+    bool RigidBody::IsTickThreadSafe()
+    {
+        return false;
+    }
+
     void RigidBody::TeleportMove() {
         teleported = true;
         UpdateGlobals();
+        ResetInterpolation();
         Flux::Info("Global position: {}, {}", globalPosition.x, globalPosition.y);
         b2Body_SetTransform(bodyId, ToB2Vec2(globalPosition), b2Rot_identity);
     }
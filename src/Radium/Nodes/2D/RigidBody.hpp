@@ -99,6 +99,11 @@ namespace Radium::Nodes {
          */
         void OnTick(float dt) override;
 
+        /**
+         * @brief RigidBody ticks talk to the Box2D world, so they always run on the main thread.
+         */
+        bool IsTickThreadSafe() override;
+
         /**
          * @brief Apply a force to the center of the body.
          * 
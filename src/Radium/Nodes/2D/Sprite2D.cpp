@@ -1,5 +1,7 @@
 #include <Radium/Nodes/2D/Sprite2D.hpp>
+#include <Radium/Nodes/2D/SpriteGrid.hpp>
 #include <Radium/SpriteBatchRegistry.hpp>
+#include <Radium/RenderQueue.hpp>
 #include <Radium/PixelScaleUtil.hpp>
 #include <Radium/Application.hpp>
 #include <Rune/SpriteBatch.hpp>
@@ -19,30 +21,65 @@ void Sprite2D::Register() {
     CLASSDB_DECLARE_PROPERTY(Sprite2D, uint32_t, textureWidth);
     CLASSDB_DECLARE_PROPERTY(Sprite2D, uint32_t, textureHeight);
     CLASSDB_DECLARE_PROPERTY(Sprite2D, float, z);
+    CLASSDB_DECLARE_PROPERTY(Sprite2D, int, layer);
     CLASSDB_DECLARE_PROPERTY(Sprite2D, uint32_t, flags);
     CLASSDB_DECLARE_PROPERTY(Sprite2D, std::string, batchTag);
     CLASSDB_DECLARE_PROPERTY(Sprite2D, CoordinateOrigin, origin);
 }
 
+const SpriteGrid* Sprite2D::culledBy = nullptr;
+
 void Sprite2D::OnRender() {
     Node2D::OnRender();
-    
-    Rune::SpriteBatch* batch = nullptr;
-    batch = Radium::SpriteBatchRegistry::Get(batchTag);
-    
-    if (!batch) {
+
+    if (culledBy && culledBy->Contains(this)) {
+        return;
+    }
+
+    Draw();
+}
+
+void Sprite2D::ResolveBatch() {
+    uint32_t generation = Radium::SpriteBatchRegistry::GetGeneration();
+    if (batchGeneration == generation && resolvedBatchTag == batchTag) {
+        return;
+    }
+
+    batchHandle = Radium::SpriteBatchRegistry::Find(batchTag);
+    resolvedBatchTag = batchTag;
+    batchGeneration = generation;
+
+    Radium::SpriteBatchRegistry::Region region = Radium::SpriteBatchRegistry::GetRegion(batchTag);
+    atlasOffsetX = region.offsetX;
+    atlasOffsetY = region.offsetY;
+    atlasWidth = region.textureWidth;
+    atlasHeight = region.textureHeight;
+
+    if (batchHandle == Radium::SpriteBatchRegistry::InvalidHandle && !Radium::SpriteBatchRegistry::IsHeadless()) {
         Flux::Error("Sprite2D: No sprite batch with tag '{}'", batchTag);
+    }
+}
+
+void Sprite2D::Draw() {
+    ResolveBatch();
+
+    Rune::SpriteBatch* batch = Radium::SpriteBatchRegistry::Get(batchHandle);
+    if (!batch) {
         return;
     }
     
-    if (!batch->started) {
+    if (!Radium::RenderQueue::current && !batch->started) {
         batch->Begin();
     }
     
     if (sourceRect.w > 0 && sourceRect.h > 0) {
-        // Apply camera offset to world position
+        // Interpolate between the last two ticks, then apply camera offset to world position
         Radium::Vector2f screenPos = globalPosition;
+        float renderRotation = globalRotation;
         if (Radium::currentApplication) {
+            float alpha = Radium::currentApplication->GetInterpolationAlpha();
+            screenPos = GetInterpolatedGlobalPosition(alpha);
+            renderRotation = GetInterpolatedGlobalRotation(alpha);
             screenPos = screenPos - Radium::currentApplication->GetCamera()->offset;
         }
         
@@ -57,15 +94,36 @@ void Sprite2D::OnRender() {
         // Calculate display size - if size is set, use it, otherwise use sourceRect dimensions
         uint32_t displayW = (size.x > 0) ? (uint32_t)(size.x * Radium::GetPixelScale()) : (uint32_t)(sourceRect.w * Radium::GetPixelScale());
         uint32_t displayH = (size.y > 0) ? (uint32_t)(size.y * Radium::GetPixelScale()) : (uint32_t)(sourceRect.h * Radium::GetPixelScale());
+
+        // sourceRect stays in sheet coordinates, packed sheets are moved onto their atlas page here
+        uint32_t sourceX = (uint32_t)(sourceRect.x + atlasOffsetX);
+        uint32_t sourceY = (uint32_t)(sourceRect.y + atlasOffsetY);
+        uint32_t pageWidth = atlasWidth ? atlasWidth : textureWidth;
+        uint32_t pageHeight = atlasHeight ? atlasHeight : textureHeight;
         
+        if (Radium::RenderQueue::current) {
+            // Sorted by layer, z and batch when the pass ends
+            Radium::RenderQueue::current->Push(layer, {
+                batchHandle,
+                drawX, drawY,
+                displayW, displayH,
+                r, g, b,
+                sourceX, sourceY,
+                (uint32_t)sourceRect.w, (uint32_t)sourceRect.h,
+                pageWidth, pageHeight,
+                renderRotation, z, flags
+            });
+            return;
+        }
+
         batch->DrawImageRect(
             drawX, drawY,
             displayW, displayH,  // Display size (can be scaled)
             r, g, b,
-            (uint32_t)sourceRect.x, (uint32_t)sourceRect.y,  // Source position in texture
+            sourceX, sourceY,  // Source position in texture
             (uint32_t)sourceRect.w, (uint32_t)sourceRect.h,  // Source size in texture (actual UV dimensions)
-            textureWidth, textureHeight,
-            globalRotation, z, flags
+            pageWidth, pageHeight,
+            renderRotation, z, flags
         );
     }
 }
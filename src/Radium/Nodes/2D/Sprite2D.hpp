@@ -5,6 +5,7 @@
 #include <Radium/Math.hpp>
 
 namespace Radium::Nodes {
+    class SpriteGrid;
 
     /**
      * @enum CoordinateOrigin
@@ -62,6 +63,9 @@ namespace Radium::Nodes {
         /// Z-order for layering sprites (higher values render on top).
         float z = 0;
 
+        /// Layer the sprite is drawn in, every lower layer is drawn first regardless of z.
+        int layer = 0;
+
         /// Flags controlling rendering options (bitmask).
         uint32_t flags = 0;
 
@@ -74,6 +78,42 @@ namespace Radium::Nodes {
          * Override from Node2D.
          */
         void OnRender() override;
+
+        /**
+         * @brief Submit the sprite to its batch.
+         * 
+         * Called by OnRender(), or by the tree's culling pass when the sprite is in its SpriteGrid.
+         */
+        void Draw();
+
+        /// Grid of the tree currently rendering, its sprites leave drawing to the culling pass.
+        static const SpriteGrid* culledBy;
+
+    private:
+        friend class SpriteGrid;
+
+        /// SpriteGrid build that indexed this sprite, 0 if none.
+        uint32_t gridBuild = 0;
+
+        /// SpriteBatchRegistry handle of batchTag, resolved again only when the tag or the registry changes.
+        uint32_t batchHandle = UINT32_MAX;
+
+        /// The batchTag batchHandle was resolved from.
+        std::string resolvedBatchTag;
+
+        /// SpriteBatchRegistry generation batchHandle was resolved in.
+        uint32_t batchGeneration = UINT32_MAX;
+
+        /// Offset from sourceRect to the atlas page and the page size, when batchTag was packed into an atlas.
+        int atlasOffsetX = 0;
+        int atlasOffsetY = 0;
+        uint32_t atlasWidth = 0;
+        uint32_t atlasHeight = 0;
+
+        /**
+         * @brief Refresh batchHandle if batchTag or the registry changed since it was resolved.
+         */
+        void ResolveBatch();
     };
 
 }
@@ -0,0 +1,202 @@
+#include <Radium/Nodes/2D/SpriteGrid.hpp>
+#include <Radium/Nodes/2D/Sprite2D.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace Radium::Nodes {
+    // Shared by every grid so a sprite indexed by one tree never matches another
+    static uint32_t nextBuildId = 1;
+
+    void SpriteGrid::Build(const std::vector<Node*>& roots) {
+        Clear();
+        buildId = nextBuildId++;
+
+        for (auto* root : roots) {
+            AddRecursive(root);
+        }
+
+        Update();
+    }
+
+    void SpriteGrid::Clear() {
+        // Sprites may already be gone, the build id they hold simply stops matching
+        entries.clear();
+        cells.clear();
+        oversized.clear();
+        buildId = 0;
+    }
+
+    void SpriteGrid::AddRecursive(Node* node) {
+        if (auto* sprite = dynamic_cast<Sprite2D*>(node)) {
+            Entry entry;
+            entry.sprite = sprite;
+            entries.push_back(entry);
+            sprite->gridBuild = buildId;
+        }
+
+        for (auto* child : node->children) {
+            AddRecursive(child);
+        }
+    }
+
+    void SpriteGrid::Update() {
+        for (uint32_t i = 0; i < entries.size(); i++) {
+            Entry& entry = entries[i];
+            Sprite2D* sprite = entry.sprite;
+
+            float width = sprite->size.x > 0 ? sprite->size.x : sprite->sourceRect.w;
+            float height = sprite->size.y > 0 ? sprite->size.y : sprite->sourceRect.h;
+            float extent = std::sqrt(width * width + height * height);
+
+            if (entry.version == sprite->transformVersion && entry.extent == extent) {
+                continue;
+            }
+
+            entry.version = sprite->transformVersion;
+            entry.extent = extent;
+            entry.minX = std::min(sprite->globalPosition.x, sprite->previousGlobalPosition.x) - extent;
+            entry.minY = std::min(sprite->globalPosition.y, sprite->previousGlobalPosition.y) - extent;
+            entry.maxX = std::max(sprite->globalPosition.x, sprite->previousGlobalPosition.x) + extent;
+            entry.maxY = std::max(sprite->globalPosition.y, sprite->previousGlobalPosition.y) + extent;
+
+            int cellMinX = ToCell(entry.minX);
+            int cellMinY = ToCell(entry.minY);
+            int cellMaxX = ToCell(entry.maxX);
+            int cellMaxY = ToCell(entry.maxY);
+
+            if (cellMinX == entry.cellMinX && cellMinY == entry.cellMinY &&
+                cellMaxX == entry.cellMaxX && cellMaxY == entry.cellMaxY) {
+                continue;
+            }
+
+            Unplace(i);
+            entry.cellMinX = cellMinX;
+            entry.cellMinY = cellMinY;
+            entry.cellMaxX = cellMaxX;
+            entry.cellMaxY = cellMaxY;
+            Place(i);
+        }
+    }
+
+    void SpriteGrid::Query(const Radium::RectangleF& area, std::vector<Sprite2D*>& out) {
+        out.clear();
+        found.clear();
+        queryStamp++;
+
+        float maxX = area.x + area.w;
+        float maxY = area.y + area.h;
+
+        auto consider = [&](uint32_t index) {
+            Entry& entry = entries[index];
+            if (entry.queryStamp == queryStamp) {
+                return;
+            }
+            entry.queryStamp = queryStamp;
+
+            if (entry.maxX >= area.x && entry.minX <= maxX && entry.maxY >= area.y && entry.minY <= maxY) {
+                found.push_back(index);
+            }
+        };
+
+        int cellMinX = ToCell(area.x);
+        int cellMinY = ToCell(area.y);
+        int cellMaxX = ToCell(maxX);
+        int cellMaxY = ToCell(maxY);
+
+        int64_t areaCells = (int64_t)(cellMaxX - cellMinX + 1) * (cellMaxY - cellMinY + 1);
+        if (areaCells > (int64_t)cells.size()) {
+            // Zoomed far out, walking the occupied cells is cheaper than probing empty ones
+            for (auto& [key, list] : cells) {
+                for (uint32_t index : list) {
+                    consider(index);
+                }
+            }
+        } else {
+            for (int y = cellMinY; y <= cellMaxY; y++) {
+                for (int x = cellMinX; x <= cellMaxX; x++) {
+                    auto it = cells.find(CellKey(x, y));
+                    if (it == cells.end()) {
+                        continue;
+                    }
+                    for (uint32_t index : it->second) {
+                        consider(index);
+                    }
+                }
+            }
+        }
+
+        for (uint32_t index : oversized) {
+            consider(index);
+        }
+
+        // Entries are in tree order, so sorting the indices keeps the draw order stable
+        std::sort(found.begin(), found.end());
+        for (uint32_t index : found) {
+            out.push_back(entries[index].sprite);
+        }
+    }
+
+    bool SpriteGrid::Contains(const Sprite2D* sprite) const {
+        return buildId != 0 && sprite->gridBuild == buildId;
+    }
+
+    size_t SpriteGrid::GetCount() const {
+        return entries.size();
+    }
+
+    void SpriteGrid::Place(uint32_t index) {
+        Entry& entry = entries[index];
+
+        int64_t cellCount = (int64_t)(entry.cellMaxX - entry.cellMinX + 1) * (entry.cellMaxY - entry.cellMinY + 1);
+        entry.oversized = cellCount > maxCellsPerSprite;
+        if (entry.oversized) {
+            oversized.push_back(index);
+            return;
+        }
+
+        for (int y = entry.cellMinY; y <= entry.cellMaxY; y++) {
+            for (int x = entry.cellMinX; x <= entry.cellMaxX; x++) {
+                cells[CellKey(x, y)].push_back(index);
+            }
+        }
+    }
+
+    void SpriteGrid::Unplace(uint32_t index) {
+        Entry& entry = entries[index];
+
+        auto erase = [index](std::vector<uint32_t>& list) {
+            auto it = std::find(list.begin(), list.end(), index);
+            if (it != list.end()) {
+                *it = list.back();
+                list.pop_back();
+            }
+        };
+
+        if (entry.oversized) {
+            erase(oversized);
+            return;
+        }
+
+        for (int y = entry.cellMinY; y <= entry.cellMaxY; y++) {
+            for (int x = entry.cellMinX; x <= entry.cellMaxX; x++) {
+                auto it = cells.find(CellKey(x, y));
+                if (it == cells.end()) {
+                    continue;
+                }
+
+                erase(it->second);
+                if (it->second.empty()) {
+                    cells.erase(it);
+                }
+            }
+        }
+    }
+
+    int SpriteGrid::ToCell(float value) const {
+        return (int)std::floor(value / cellSize);
+    }
+
+    uint64_t SpriteGrid::CellKey(int x, int y) {
+        return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+    }
+}
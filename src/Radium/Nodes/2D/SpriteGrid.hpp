@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <Radium/Nodes/Node.hpp>
+#include <Radium/Math.hpp>
+
+namespace Radium::Nodes {
+    class Sprite2D;
+
+    /**
+     * @brief Uniform grid over the Sprite2D nodes in a tree, used to find the ones on screen
+     *
+     * Each sprite is stored in every cell its bounds touch. The bounds cover both the previous
+     * and the current tick transform, since sprites render interpolated between the two, and
+     * are grown by the sprite's diagonal so rotation and either origin stay inside them.
+     * Update() only re-buckets sprites whose Node2D transform or size changed.
+     */
+    class SpriteGrid {
+    public:
+        /**
+         * @brief Width and height of a cell in world units
+         */
+        float cellSize = 256.0f;
+
+        /**
+         * @brief Index every Sprite2D under the given roots
+         *
+         * Must be called again whenever sprites are added, removed or reparented.
+         *
+         * @param roots The root nodes of the tree
+         */
+        void Build(const std::vector<Node*>& roots);
+
+        /**
+         * @brief Forget every sprite
+         */
+        void Clear();
+
+        /**
+         * @brief Move sprites whose bounds changed since the last update to their new cells
+         */
+        void Update();
+
+        /**
+         * @brief Find the sprites whose bounds intersect an area
+         *
+         * @param area World rectangle, x and y being its minimum corner
+         * @param out Filled with the sprites, in tree order
+         */
+        void Query(const Radium::RectangleF& area, std::vector<Sprite2D*>& out);
+
+        /**
+         * @brief Whether a sprite was indexed by the last Build()
+         */
+        bool Contains(const Sprite2D* sprite) const;
+
+        /**
+         * @brief Get the number of indexed sprites
+         */
+        size_t GetCount() const;
+
+    private:
+        struct Entry {
+            Sprite2D* sprite;
+            /// Node2D transformVersion the bounds were computed from
+            uint32_t version = 0;
+            /// Diagonal of the sprite the bounds were computed from
+            float extent = -1.0f;
+            float minX = 0, minY = 0, maxX = 0, maxY = 0;
+            int cellMinX = 0, cellMinY = 0, cellMaxX = -1, cellMaxY = -1;
+            /// Stored in the oversized list instead of the cells
+            bool oversized = false;
+            /// Last query that reported this entry
+            uint32_t queryStamp = 0;
+        };
+
+        /// Sprites touching more cells than this are checked on every query instead
+        static constexpr int maxCellsPerSprite = 64;
+
+        /// Entries in tree order
+        std::vector<Entry> entries;
+        std::unordered_map<uint64_t, std::vector<uint32_t>> cells;
+        std::vector<uint32_t> oversized;
+        std::vector<uint32_t> found;
+        uint32_t queryStamp = 0;
+        /// Identifies the last Build(), sprites remember the one that indexed them
+        uint32_t buildId = 0;
+
+        void AddRecursive(Node* node);
+        void Place(uint32_t index);
+        void Unplace(uint32_t index);
+        int ToCell(float value) const;
+
+        static uint64_t CellKey(int x, int y);
+    };
+}
@@ -0,0 +1,284 @@
+#include <Radium/Nodes/2D/SpriteInstances2D.hpp>
+#include <Radium/Nodes/LuaScript.hpp>
+#include <Radium/SpriteBatchRegistry.hpp>
+#include <Radium/PixelScaleUtil.hpp>
+#include <Radium/Application.hpp>
+#include <Rune/SpriteBatch.hpp>
+#include <Flux/Flux.hpp>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+
+namespace Radium::Nodes {
+
+    static uint8_t to_channel(float value) {
+        return (uint8_t)(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    // Instance argument of a Lua binding, converted from 1 based
+    static size_t check_instance(lua_State *L, SpriteInstances2D *instance, int arg) {
+        lua_Integer index = luaL_checkinteger(L, arg);
+        luaL_argcheck(L, index >= 1 && (size_t)index <= instance->GetInstanceCount(), arg, "instance index out of range");
+        return (size_t)(index - 1);
+    }
+
+    SpriteInstances2D::SpriteInstances2D() {
+    }
+
+    void SpriteInstances2D::Register() {
+        CLASSDB_REGISTER_SUBCLASS(SpriteInstances2D, Node2D);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, Radium::RectangleF, sourceRect);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, float, r);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, float, g);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, float, b);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, uint32_t, textureWidth);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, uint32_t, textureHeight);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, float, z);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, int, layer);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, uint32_t, flags);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, std::string, batchTag);
+        CLASSDB_DECLARE_PROPERTY(SpriteInstances2D, CoordinateOrigin, origin);
+
+        // Lua function bindings
+        LUA_FUNC("Radium::Nodes::SpriteInstances2D::SetInstanceCount", [](lua_State *L) -> int
+                 {
+            SpriteInstances2D* instance = (SpriteInstances2D*)lua_touserdata(L, lua_upvalueindex(1));
+            lua_Integer count = luaL_checkinteger(L, 2);
+            luaL_argcheck(L, count >= 0, 2, "count must not be negative");
+
+            instance->SetInstanceCount((size_t)count);
+            return 0; });
+
+        LUA_FUNC("Radium::Nodes::SpriteInstances2D::GetInstanceCount", [](lua_State *L) -> int
+                 {
+            SpriteInstances2D* instance = (SpriteInstances2D*)lua_touserdata(L, lua_upvalueindex(1));
+            lua_pushinteger(L, (lua_Integer)instance->GetInstanceCount());
+            return 1; });
+
+        LUA_FUNC("Radium::Nodes::SpriteInstances2D::SetInstance", [](lua_State *L) -> int
+                 {
+            SpriteInstances2D* instance = (SpriteInstances2D*)lua_touserdata(L, lua_upvalueindex(1));
+            size_t index = check_instance(L, instance, 2);
+            float x = luaL_checknumber(L, 3);
+            float y = luaL_checknumber(L, 4);
+            float rotation = luaL_optnumber(L, 5, instance->GetInstance(index).rotation);
+
+            instance->SetInstancePosition(index, Radium::Vector2f(x, y), rotation);
+            return 0; });
+
+        LUA_FUNC("Radium::Nodes::SpriteInstances2D::SetInstanceSource", [](lua_State *L) -> int
+                 {
+            SpriteInstances2D* instance = (SpriteInstances2D*)lua_touserdata(L, lua_upvalueindex(1));
+            size_t index = check_instance(L, instance, 2);
+
+            SpriteInstance value = instance->GetInstance(index);
+            value.sourceX = (uint16_t)luaL_checkinteger(L, 3);
+            value.sourceY = (uint16_t)luaL_checkinteger(L, 4);
+            value.sourceWidth = (uint16_t)luaL_checkinteger(L, 5);
+            value.sourceHeight = (uint16_t)luaL_checkinteger(L, 6);
+            instance->SetInstance(index, value);
+            return 0; });
+
+        LUA_FUNC("Radium::Nodes::SpriteInstances2D::SetInstanceColor", [](lua_State *L) -> int
+                 {
+            SpriteInstances2D* instance = (SpriteInstances2D*)lua_touserdata(L, lua_upvalueindex(1));
+            size_t index = check_instance(L, instance, 2);
+
+            SpriteInstance value = instance->GetInstance(index);
+            value.r = to_channel(luaL_checknumber(L, 3));
+            value.g = to_channel(luaL_checknumber(L, 4));
+            value.b = to_channel(luaL_checknumber(L, 5));
+            instance->SetInstance(index, value);
+            return 0; });
+
+        LUA_FUNC("Radium::Nodes::SpriteInstances2D::SetPositions", [](lua_State *L) -> int
+                 {
+            SpriteInstances2D* instance = (SpriteInstances2D*)lua_touserdata(L, lua_upvalueindex(1));
+            luaL_checktype(L, 2, LUA_TTABLE);
+
+            size_t count = std::min(instance->GetInstanceCount(), (size_t)lua_rawlen(L, 2) / 2);
+            for (size_t i = 0; i < count; i++)
+            {
+                lua_rawgeti(L, 2, (lua_Integer)(i * 2 + 1));
+                lua_rawgeti(L, 2, (lua_Integer)(i * 2 + 2));
+                float x = lua_tonumber(L, -2);
+                float y = lua_tonumber(L, -1);
+                lua_pop(L, 2);
+
+                instance->SetInstancePosition(i, Radium::Vector2f(x, y), instance->GetInstance(i).rotation);
+            }
+            return 0; });
+    }
+
+    void SpriteInstances2D::SetInstanceCount(size_t count) {
+        size_t previous = instances.size();
+
+        SpriteInstance initial;
+        initial.sourceX = (uint16_t)sourceRect.x;
+        initial.sourceY = (uint16_t)sourceRect.y;
+        initial.sourceWidth = (uint16_t)sourceRect.w;
+        initial.sourceHeight = (uint16_t)sourceRect.h;
+        initial.r = to_channel(r);
+        initial.g = to_channel(g);
+        initial.b = to_channel(b);
+
+        instances.resize(count, initial);
+        baked.resize(count);
+        isDirty.resize(count, 0);
+
+        for (size_t i = previous; i < count; i++) {
+            MarkDirty(i);
+        }
+    }
+
+    size_t SpriteInstances2D::GetInstanceCount() const {
+        return instances.size();
+    }
+
+    const SpriteInstance& SpriteInstances2D::GetInstance(size_t index) const {
+        return instances[index];
+    }
+
+    void SpriteInstances2D::SetInstance(size_t index, const SpriteInstance& instance) {
+        instances[index] = instance;
+        MarkDirty(index);
+    }
+
+    void SpriteInstances2D::SetInstancePosition(size_t index, const Radium::Vector2f& position, float rotation) {
+        SpriteInstance& instance = instances[index];
+        if (instance.position == position && instance.rotation == rotation) {
+            return;
+        }
+
+        instance.position = position;
+        instance.rotation = rotation;
+        MarkDirty(index);
+    }
+
+    void SpriteInstances2D::MarkDirty(size_t index) {
+        if (!isDirty[index]) {
+            isDirty[index] = 1;
+            dirty.push_back((uint32_t)index);
+        }
+    }
+
+    void SpriteInstances2D::Bake(size_t index, float pixelScale) {
+        const SpriteInstance& instance = instances[index];
+        SpriteCommand& command = baked[index];
+
+        float width = instance.size.x > 0 ? instance.size.x : (size.x > 0 ? size.x : instance.sourceWidth);
+        float height = instance.size.y > 0 ? instance.size.y : (size.y > 0 ? size.y : instance.sourceHeight);
+
+        command.batch = batchHandle;
+        command.x = instance.position.x * pixelScale;
+        command.y = -instance.position.y * pixelScale;
+        command.width = (uint32_t)(width * pixelScale);
+        command.height = (uint32_t)(height * pixelScale);
+        command.r = instance.r / 255.0f;
+        command.g = instance.g / 255.0f;
+        command.b = instance.b / 255.0f;
+        command.sourceX = (uint32_t)(instance.sourceX + region.offsetX);
+        command.sourceY = (uint32_t)(instance.sourceY + region.offsetY);
+        command.sourceWidth = instance.sourceWidth;
+        command.sourceHeight = instance.sourceHeight;
+        command.textureWidth = region.textureWidth ? region.textureWidth : textureWidth;
+        command.textureHeight = region.textureHeight ? region.textureHeight : textureHeight;
+        command.rotation = instance.rotation;
+        command.z = instance.z;
+        command.flags = flags;
+    }
+
+    void SpriteInstances2D::OnRender() {
+        Node2D::OnRender();
+
+        if (instances.empty()) {
+            return;
+        }
+
+        ZoneScopedN("Sprite Instances");
+
+        uint32_t generation = Radium::SpriteBatchRegistry::GetGeneration();
+        bool bakeAll = false;
+        if (bakedGeneration != generation || bakedTag != batchTag) {
+            batchHandle = Radium::SpriteBatchRegistry::Find(batchTag);
+            region = Radium::SpriteBatchRegistry::GetRegion(batchTag);
+            bakedGeneration = generation;
+            bakedTag = batchTag;
+            bakeAll = true;
+
+            if (batchHandle == Radium::SpriteBatchRegistry::InvalidHandle && !Radium::SpriteBatchRegistry::IsHeadless()) {
+                Flux::Error("SpriteInstances2D: No sprite batch with tag '{}'", batchTag);
+            }
+        }
+
+        Rune::SpriteBatch* batch = Radium::SpriteBatchRegistry::Get(batchHandle);
+        if (!batch) {
+            return;
+        }
+
+        float pixelScale = Radium::GetPixelScale();
+        if (bakedPixelScale != pixelScale || bakedSize != size || bakedFlags != flags ||
+            bakedTextureWidth != textureWidth || bakedTextureHeight != textureHeight) {
+            bakedPixelScale = pixelScale;
+            bakedSize = size;
+            bakedFlags = flags;
+            bakedTextureWidth = textureWidth;
+            bakedTextureHeight = textureHeight;
+            bakeAll = true;
+        }
+
+        // Only what changed since the last frame is baked again
+        if (bakeAll) {
+            for (size_t i = 0; i < instances.size(); i++) {
+                Bake(i, pixelScale);
+            }
+        } else {
+            for (uint32_t index : dirty) {
+                if (index < instances.size()) {
+                    Bake(index, pixelScale);
+                }
+            }
+        }
+        for (uint32_t index : dirty) {
+            if (index < isDirty.size()) {
+                isDirty[index] = 0;
+            }
+        }
+        dirty.clear();
+
+        // The transform shared by every instance, applied once to the whole run
+        Radium::Vector2f screenPos = globalPosition;
+        if (Radium::currentApplication) {
+            screenPos = GetInterpolatedGlobalPosition(Radium::currentApplication->GetInterpolationAlpha());
+            screenPos = screenPos - Radium::currentApplication->GetCamera()->offset;
+        }
+
+        float offsetX = screenPos.x * pixelScale;
+        float offsetY = -screenPos.y * pixelScale;
+        if (origin == CoordinateOrigin::Center) {
+            offsetX += Rune::windowWidth / 2.0f;
+            offsetY += Rune::windowHeight / 2.0f;
+        }
+
+        if (Radium::RenderQueue::current) {
+            Radium::RenderQueue::current->PushRun(layer, z, batchHandle, baked.data(), baked.size(), offsetX, offsetY);
+            return;
+        }
+
+        if (!batch->started) {
+            batch->Begin();
+        }
+
+        for (const SpriteCommand& command : baked) {
+            batch->DrawImageRect(
+                command.x + offsetX, command.y + offsetY,
+                command.width, command.height,
+                command.r, command.g, command.b,
+                command.sourceX, command.sourceY,
+                command.sourceWidth, command.sourceHeight,
+                command.textureWidth, command.textureHeight,
+                command.rotation, command.z, command.flags
+            );
+        }
+    }
+
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <vector>
+#include <Radium/Nodes/ClassDB.hpp>
+#include <Radium/Nodes/2D/Node2D.hpp>
+#include <Radium/Nodes/2D/Sprite2D.hpp>
+#include <Radium/RenderQueue.hpp>
+#include <Radium/Math.hpp>
+
+namespace Radium::Nodes {
+
+    /**
+     * @brief One sprite drawn by a SpriteInstances2D, kept compact so large counts stay cheap.
+     */
+    struct SpriteInstance {
+        /// Position relative to the node, in world units.
+        Radium::Vector2f position = {0, 0};
+
+        /// Size in world units, 0 uses the node's size, or the source size if that is 0 as well.
+        Radium::Vector2f size = {0, 0};
+
+        /// Rotation of the sprite.
+        float rotation = 0;
+
+        /// Z the sprite is drawn with.
+        float z = 0;
+
+        /// Source region in the sheet, in pixels.
+        uint16_t sourceX = 0, sourceY = 0, sourceWidth = 0, sourceHeight = 0;
+
+        /// Tint, 0 to 255 per channel.
+        uint8_t r = 0, g = 0, b = 0;
+    };
+
+    /**
+     * @class SpriteInstances2D
+     * @brief Draws many sprites of one batch without a node per sprite, for particles and swarms.
+     *
+     * Every instance is baked once into a ready to submit quad in pixels, relative to the node, and
+     * only baked again when it is changed, when the pixel scale changes or when the batch resolves
+     * to another atlas region. The camera, the node position and the origin adjust are one offset
+     * applied to the whole run when it is submitted, so moving the node or the camera touches no
+     * instance. The run is queued as a single item of the render queue, sorted by the node's layer
+     * and z.
+     *
+     * The node's rotation is not applied to the instances, and the instances are not culled.
+     *
+     * From Lua:
+     * - `node:SetInstanceCount(count)` / `node:GetInstanceCount()`
+     * - `node:SetInstance(index, x, y, rotation)`, index starting at 1, rotation optional
+     * - `node:SetInstanceSource(index, x, y, w, h)` / `node:SetInstanceColor(index, r, g, b)`
+     * - `node:SetPositions(values)`, a flat array of x, y pairs starting at the first instance
+     */
+    class SpriteInstances2D : public Node2D {
+    public:
+        SpriteInstances2D();
+
+        /**
+         * @brief Registers the SpriteInstances2D class with the ClassDB system.
+         */
+        static void Register();
+
+        /// Source region given to new instances.
+        Radium::RectangleF sourceRect{0, 0, 0, 0};
+
+        /// Tint given to new instances (0 to 1).
+        float r = 0;
+        float g = 0;
+        float b = 0;
+
+        /// Width of the texture in pixels.
+        uint32_t textureWidth = 0;
+
+        /// Height of the texture in pixels.
+        uint32_t textureHeight = 0;
+
+        /// Z the run is sorted by.
+        float z = 0;
+
+        /// Layer the run is drawn in.
+        int layer = 0;
+
+        /// Flags controlling rendering options (bitmask).
+        uint32_t flags = 0;
+
+        /// Tag of the sprite batch every instance is drawn with.
+        std::string batchTag;
+
+        /// Origin point of every instance.
+        CoordinateOrigin origin = CoordinateOrigin::TopLeft;
+
+        /**
+         * @brief Set the number of instances, new ones use the node's sourceRect and tint.
+         */
+        void SetInstanceCount(size_t count);
+
+        /// @brief Get the number of instances.
+        size_t GetInstanceCount() const;
+
+        /// @brief Get an instance, changes must go through Set.
+        const SpriteInstance& GetInstance(size_t index) const;
+
+        /// @brief Replace an instance, marking it to be baked again.
+        void SetInstance(size_t index, const SpriteInstance& instance);
+
+        /// @brief Move an instance, marking it to be baked again if it moved.
+        void SetInstancePosition(size_t index, const Radium::Vector2f& position, float rotation);
+
+        /**
+         * @brief Called every render frame to draw the instances.
+         *
+         * Override from Node2D.
+         */
+        void OnRender() override;
+
+    private:
+        std::vector<SpriteInstance> instances;
+
+        /// Baked quads, one per instance, relative to the node's screen position.
+        std::vector<SpriteCommand> baked;
+
+        /// Instances changed since the last bake.
+        std::vector<uint32_t> dirty;
+        std::vector<uint8_t> isDirty;
+
+        /// Everything is baked again when any of these change.
+        float bakedPixelScale = 0;
+        uint32_t bakedGeneration = UINT32_MAX;
+        std::string bakedTag;
+        Radium::Vector2f bakedSize = {0, 0};
+        uint32_t bakedFlags = 0;
+        uint32_t bakedTextureWidth = 0;
+        uint32_t bakedTextureHeight = 0;
+
+        uint32_t batchHandle = UINT32_MAX;
+        Radium::SpriteBatchRegistry::Region region;
+
+        void MarkDirty(size_t index);
+        void Bake(size_t index, float pixelScale);
+    };
+
+}
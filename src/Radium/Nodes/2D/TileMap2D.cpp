@@ -2,6 +2,7 @@
 #include <Radium/Nodes/LuaScript.hpp>
 #include <Radium/PixelScaleUtil.hpp>
 #include <Radium/Application.hpp>
+#include <Radium/SpriteBatchRegistry.hpp>
 
 // Helper to set a pixel at (x, y) with RGBA color
 void SetPixelRGBA(void *surface, int x, int y, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
@@ -40,6 +41,12 @@ namespace Radium::Nodes
     TileMap2D::TileMap2D()
         : tileSize(16, 16), tileOffset(0, 0), tileSeperation(0, 0)
     {
+        // No GPU in headless mode, the map only keeps its tiles
+        if (Radium::SpriteBatchRegistry::IsHeadless())
+        {
+            return;
+        }
+
         std::vector<float> quad = {
             //  x,   y,     u,    v
             0.0f, 1.0f,  0.0f, 1.0f,  // Top Left
@@ -81,6 +88,11 @@ namespace Radium::Nodes
 
     void TileMap2D::OnRender()
     {
+        if (Radium::SpriteBatchRegistry::IsHeadless())
+        {
+            return;
+        }
+
         float scale = Radium::GetPixelScale();
         for (auto pair : chunks) {
             Vector2i pos = pair.first;
@@ -42,7 +42,7 @@ namespace Radium::Nodes {
     /// @brief 2D tile map node.
     class TileMap2D : public Node2D {
     private:
-        Rune::SpriteBatch* batch;
+        Rune::SpriteBatch* batch = nullptr;
 
         std::unordered_map<Vector2i, TileChunk*> chunks;
 
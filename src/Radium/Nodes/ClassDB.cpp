@@ -16,10 +16,35 @@ namespace Radium::Nodes {
 
     namespace ClassDB {
         std::unordered_map<std::string, ClassDB::ClassInfo> registeredClasses;
-        std::vector<std::string> enums;
+        std::unordered_set<std::string> enums;
+        std::unordered_map<std::type_index, ClassDB::ClassInfo*> classesByType;
+        uint32_t registryVersion = 1;
     }
     
 
+    // Written only while registering, read from any thread afterwards
+    static std::unordered_map<std::type_index, std::string> typeNames;
+
+    const std::string& RegisterTypeName(const std::type_info& type) {
+        auto it = typeNames.find(std::type_index(type));
+        if (it == typeNames.end()) {
+            it = typeNames.emplace(std::type_index(type), Demangle(type.name())).first;
+        }
+        return it->second;
+    }
+
+    const std::string& GetTypeName(const std::type_info& type) {
+        auto it = typeNames.find(std::type_index(type));
+        if (it != typeNames.end()) {
+            return it->second;
+        }
+
+        // Never registered, demangle into a per-thread buffer rather than touching the cache
+        thread_local std::string fallback;
+        fallback = Demangle(type.name());
+        return fallback;
+    }
+
     std::string Demangle(const char* name) {
     #if defined(_MSC_VER)
         char demangledName[1024];
@@ -6,11 +6,14 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <typeinfo>
 #include <Flux/Flux.hpp>
 #include <algorithm>
 #include <functional>
 #include <stdexcept>
+#include <type_traits>
+#include <typeindex>
 
 /**
  * @brief Calculate the offset of a member variable within a class.
@@ -30,11 +33,39 @@ constexpr size_t offsetOf(U T::*member)
 #define CLASSDB_REGISTER_SUBCLASS(className, parentName) Radium::Nodes::ClassDB::Register<className, parentName>()
 #define CLASSDB_DECLARE_PROPERTY(className, type, propertyName) Radium::Nodes::ClassDB::RegisterProperty<className, type>(#propertyName, offsetOf(&className::propertyName), sizeof(type))
 
+namespace Radium
+{
+    class Vector2f;
+    class RectangleF;
+}
+
 namespace Radium::Nodes
 {
 
     std::string Demangle(const char *name);
 
+    /**
+     * @brief Demangle a type once and cache its name by std::type_index.
+     *
+     * Called by ClassDB registration, on the main thread, before any node is constructed.
+     *
+     * @param type Type to register the name of
+     * @return const std::string& Demangled name, valid for the lifetime of the program
+     */
+    const std::string &RegisterTypeName(const std::type_info &type);
+
+    /**
+     * @brief Get the demangled name of a type.
+     *
+     * Types seen by ClassDB registration only do a hash lookup. The cache is never written
+     * here, so this is safe from any thread without a lock.
+     *
+     * @param type Type to get the name of
+     * @return const std::string& Demangled name. Valid for the lifetime of the program for
+     * registered types, otherwise until the next call on the same thread.
+     */
+    const std::string &GetTypeName(const std::type_info &type);
+
     class Object
     {
     public:
@@ -43,6 +74,27 @@ namespace Radium::Nodes
 
     namespace ClassDB
     {
+        /**
+         * @enum PropertyKind
+         * @brief Type tag for the property types the engine handles specially.
+         * 
+         * Worked out from the C++ type at registration, so callers can switch on it instead
+         * of comparing demangled type names, which differ between standard libraries.
+         */
+        enum class PropertyKind : uint8_t
+        {
+            Other,
+            Int,
+            UnsignedInt,
+            Float,
+            Bool,
+            String,
+            Enum,
+            Vector2f,
+            RectangleF,
+            Pointer
+        };
+
         /**
          * @struct PropertyInfo
          * @brief Stores metadata about a class property.
@@ -56,8 +108,47 @@ namespace Radium::Nodes
             std::string type; /**< The type of the property, demangled */
             size_t offset; /**< Byte offset of the property within the class */
             size_t size; /**< Size of the property in bytes */
+            PropertyKind kind = PropertyKind::Other; /**< Type tag of the property */
+            bool isEnum = false; /**< Whether the property is an enum, of any underlying type */
         };
 
+        /**
+         * @struct PropertyId
+         * @brief A property resolved once for a class, cheap to use for repeated access.
+         * 
+         * Obtained from ResolveProperty(). Offsets never change after registration, so a
+         * PropertyId stays valid for every instance of the class it was resolved on.
+         */
+        struct PropertyId
+        {
+            size_t offset = 0; /**< Byte offset of the property within the class */
+            size_t size = 0; /**< Size of the property in bytes */
+            PropertyKind kind = PropertyKind::Other; /**< Type tag of the property */
+            bool valid = false; /**< False if the property was not found */
+
+            explicit operator bool() const { return valid; }
+        };
+
+        /**
+         * @brief Work out the PropertyKind for a C++ type.
+         *
+         * @tparam T Property type
+         */
+        template <typename T>
+        constexpr PropertyKind KindOf()
+        {
+            if constexpr (std::is_same_v<T, int>) return PropertyKind::Int;
+            else if constexpr (std::is_same_v<T, unsigned int>) return PropertyKind::UnsignedInt;
+            else if constexpr (std::is_same_v<T, float>) return PropertyKind::Float;
+            else if constexpr (std::is_same_v<T, bool>) return PropertyKind::Bool;
+            else if constexpr (std::is_same_v<T, std::string>) return PropertyKind::String;
+            else if constexpr (std::is_enum_v<T> && sizeof(T) == sizeof(int)) return PropertyKind::Enum;
+            else if constexpr (std::is_same_v<T, Radium::Vector2f>) return PropertyKind::Vector2f;
+            else if constexpr (std::is_same_v<T, Radium::RectangleF>) return PropertyKind::RectangleF;
+            else if constexpr (std::is_pointer_v<T>) return PropertyKind::Pointer;
+            else return PropertyKind::Other;
+        }
+
         /**
          * @struct ClassInfo
          * @brief Holds reflection metadata for a registered class
@@ -71,6 +162,13 @@ namespace Radium::Nodes
             ClassInfo *parent = nullptr;
             std::string name;
             std::function<Object *()> factory;
+
+            /// Own and inherited properties, base class first, built on first lookup
+            std::vector<PropertyInfo> allProperties;
+            /// Index into allProperties by name, derived classes shadow their parents
+            std::unordered_map<std::string, size_t> propertyLookup;
+            /// registryVersion the lookup tables were built at, 0 if never built
+            uint32_t lookupVersion = 0;
         };
 
         // Declarations
@@ -81,7 +179,15 @@ namespace Radium::Nodes
         /**
          * Holds a list for the names of all registered enums
          */
-        extern std::vector<std::string> enums;
+        extern std::unordered_set<std::string> enums;
+        /**
+         * Maps C++ types to their entry in registeredClasses, so lookups skip demangling
+         */
+        extern std::unordered_map<std::type_index, ClassInfo *> classesByType;
+        /**
+         * Bumped whenever a class or property is registered, invalidates the per-class lookup tables
+         */
+        extern uint32_t registryVersion;
 
         /**
          * @brief Register a class with ClassDB.
@@ -91,7 +197,7 @@ namespace Radium::Nodes
         template <typename T>
         void Register()
         {
-            std::string typeName = Demangle(typeid(T).name());
+            const std::string &typeName = RegisterTypeName(typeid(T));
             if (registeredClasses.find(typeName) != registeredClasses.end())
             {
                 return;
@@ -105,6 +211,8 @@ namespace Radium::Nodes
             };
             info.name = typeName;
             registeredClasses[typeName] = info;
+            classesByType[std::type_index(typeid(T))] = &registeredClasses[typeName];
+            registryVersion++;
         }
         /**
          * @brief Register an enum type with ClassDB.
@@ -114,12 +222,17 @@ namespace Radium::Nodes
         template <typename T>
         void RegisterEnum()
         {
-            enums.push_back(Demangle(typeid(T).name()));
+            enums.insert(RegisterTypeName(typeid(T)));
         }
 
-        inline bool IsEnum(std::string typeName)
+        /**
+         * @brief Check whether a demangled type name was registered with RegisterEnum.
+         *
+         * Prefer PropertyInfo::isEnum when you already have the property.
+         */
+        inline bool IsEnum(const std::string &typeName)
         {
-            return std::find(enums.begin(), enums.end(), typeName) != enums.end();
+            return enums.count(typeName) != 0;
         }
 
         /**
@@ -131,8 +244,8 @@ namespace Radium::Nodes
         template <typename T, typename P>
         void Register()
         {
-            std::string typeName = Demangle(typeid(T).name());
-            std::string parentName = Demangle(typeid(P).name());
+            const std::string &typeName = RegisterTypeName(typeid(T));
+            const std::string &parentName = RegisterTypeName(typeid(P));
 
             Flux::Info("Registering type {} with parent {}", typeName, parentName);
 
@@ -157,6 +270,8 @@ namespace Radium::Nodes
             };
             info.name = typeName;
             registeredClasses[typeName] = info;
+            classesByType[std::type_index(typeid(T))] = &registeredClasses[typeName];
+            registryVersion++;
             Flux::Info("Register finished!");
         }
 
@@ -172,15 +287,187 @@ namespace Radium::Nodes
         template <typename T1, typename T2>
         void RegisterProperty(const std::string &propertyName, size_t offset, size_t size)
         {
-            std::string typeName = Radium::Nodes::Demangle(typeid(T1).name());
-            std::string propertyType = Radium::Nodes::Demangle(typeid(T2).name());
+            const std::string &typeName = RegisterTypeName(typeid(T1));
+            const std::string &propertyType = RegisterTypeName(typeid(T2));
 
             PropertyInfo prop;
             prop.name = propertyName;
             prop.type = propertyType;
             prop.offset = offset;
             prop.size = size;
+            prop.kind = KindOf<T2>();
+            prop.isEnum = std::is_enum_v<T2>;
             registeredClasses[typeName].properties.push_back(prop);
+            registryVersion++;
+        }
+
+        /**
+         * @brief Find the class metadata for an object instance.
+         *
+         * @param instance Pointer to the object instance
+         * @return ClassInfo* The class information, or nullptr if the class is not registered
+         */
+        inline ClassInfo *FindClass(Object *instance)
+        {
+            std::type_index type(typeid(*instance));
+
+            auto cached = classesByType.find(type);
+            if (cached != classesByType.end())
+            {
+                return cached->second;
+            }
+
+            // Classes registered under a different static type still resolve by name. Not cached,
+            // registration is the only writer so lookups stay safe from worker threads
+            auto it = registeredClasses.find(GetTypeName(typeid(*instance)));
+            return it != registeredClasses.end() ? &it->second : nullptr;
+        }
+
+        /**
+         * @brief Build the flattened property table for a class if it is out of date.
+         *
+         * @param info Class to build the table for
+         */
+        inline void BuildPropertyLookup(ClassInfo *info)
+        {
+            if (info->lookupVersion == registryVersion)
+            {
+                return;
+            }
+
+            std::vector<ClassInfo *> classChain;
+            for (ClassInfo *cls = info; cls; cls = cls->parent)
+            {
+                classChain.insert(classChain.begin(), cls);
+            }
+
+            info->allProperties.clear();
+            info->propertyLookup.clear();
+            for (ClassInfo *cls : classChain)
+            {
+                for (const PropertyInfo &prop : cls->properties)
+                {
+                    info->propertyLookup[prop.name] = info->allProperties.size();
+                    info->allProperties.push_back(prop);
+                }
+            }
+
+            info->lookupVersion = registryVersion;
+        }
+
+        /**
+         * @brief Resolve a property of a class into a PropertyId.
+         *
+         * @param info Class to look the property up on, inherited properties included
+         * @param propertyName Name of the property
+         * @return PropertyId The resolved property, invalid if not found
+         */
+        inline PropertyId ResolveProperty(ClassInfo *info, const std::string &propertyName)
+        {
+            PropertyId id;
+            if (!info)
+            {
+                return id;
+            }
+
+            BuildPropertyLookup(info);
+
+            auto it = info->propertyLookup.find(propertyName);
+            if (it == info->propertyLookup.end())
+            {
+                return id;
+            }
+
+            const PropertyInfo &prop = info->allProperties[it->second];
+            id.offset = prop.offset;
+            id.size = prop.size;
+            id.kind = prop.kind;
+            id.valid = true;
+            return id;
+        }
+
+        /**
+         * @brief Resolve a property of an object's class into a PropertyId.
+         *
+         * @param instance Pointer to the object instance
+         * @param propertyName Name of the property
+         * @return PropertyId The resolved property, invalid if not found
+         */
+        inline PropertyId ResolveProperty(Object *instance, const std::string &propertyName)
+        {
+            return ResolveProperty(FindClass(instance), propertyName);
+        }
+
+        /**
+         * @brief Resolve an already looked up property into a PropertyId.
+         *
+         * @param prop Property info, e.g. from GetProperties()
+         * @return PropertyId The resolved property
+         */
+        inline PropertyId ResolveProperty(const PropertyInfo &prop)
+        {
+            PropertyId id;
+            id.offset = prop.offset;
+            id.size = prop.size;
+            id.kind = prop.kind;
+            id.valid = true;
+            return id;
+        }
+
+        /**
+         * @brief Get a pointer to a resolved property inside an object instance.
+         *
+         * @tparam T Property type
+         * @param id Property resolved on the instance's class
+         * @param instance Pointer to the object instance
+         * @return T* Pointer to the property data
+         * @throws std::runtime_error If the id is invalid or the size mismatches
+         */
+        template <typename T>
+        T *GetPropertyPointer(const PropertyId &id, Object *instance)
+        {
+            if (!id)
+            {
+                throw std::runtime_error("Property not found");
+            }
+
+            if (id.size != sizeof(T))
+            {
+                throw std::runtime_error("Property size mismatch");
+            }
+
+            uint8_t *basePtr = reinterpret_cast<uint8_t *>(instance);
+            return reinterpret_cast<T *>(basePtr + id.offset);
+        }
+
+        /**
+         * @brief Get a resolved property value from an object instance.
+         *
+         * @tparam T Property type
+         * @param id Property resolved on the instance's class
+         * @param instance Pointer to the object instance
+         * @return T Value of the property
+         * @throws std::runtime_error If the id is invalid or the size mismatches
+         */
+        template <typename T>
+        T GetProperty(const PropertyId &id, Object *instance)
+        {
+            return *GetPropertyPointer<T>(id, instance);
+        }
+
+        /**
+         * @brief Set a resolved property value on an object instance.
+         *
+         * @tparam T Property type
+         * @param id Property resolved on the instance's class
+         * @param instance Pointer to the object instance
+         * @param value New value to set
+         * @throws std::runtime_error If the id is invalid or the size mismatches
+         */
+        template <typename T>
+        void SetProperty(const PropertyId &id, Object *instance, T value)
+        {
+            *GetPropertyPointer<T>(id, instance) = value;
         }
 
         /**
@@ -195,29 +482,7 @@ namespace Radium::Nodes
         template <typename T>
         void SetProperty(std::string propertyName, Object *instance, T value)
         {
-            std::string typeName = Demangle(typeid(*instance).name());
-            ClassInfo *info = &registeredClasses[typeName];
-
-            while (info)
-            {
-                for (const PropertyInfo &prop : info->properties)
-                {
-                    if (prop.name == propertyName)
-                    {
-                        if (prop.size != sizeof(T))
-                        {
-                            throw std::runtime_error("Property size mismatch");
-                        }
-
-                        uint8_t *basePtr = reinterpret_cast<uint8_t *>(instance);
-                        *reinterpret_cast<T *>(basePtr + prop.offset) = value;
-                        return;
-                    }
-                }
-                info = info->parent;
-            }
-
-            throw std::runtime_error("Property not found");
+            SetProperty<T>(ResolveProperty(instance, propertyName), instance, value);
         }
 
         /**
@@ -232,28 +497,7 @@ namespace Radium::Nodes
         template <typename T>
         T GetProperty(std::string propertyName, Object *instance)
         {
-            std::string typeName = Demangle(typeid(*instance).name());
-            ClassInfo *info = &registeredClasses[typeName];
-
-            while (info)
-            {
-                for (const PropertyInfo &prop : info->properties)
-                {
-                    if (prop.name == propertyName)
-                    {
-                        if (prop.size != sizeof(T))
-                        {
-                            throw std::runtime_error("Property size mismatch");
-                        }
-
-                        uint8_t *basePtr = reinterpret_cast<uint8_t *>(instance);
-                        return *reinterpret_cast<T *>(basePtr + prop.offset);
-                    }
-                }
-                info = info->parent;
-            }
-
-            throw std::runtime_error("Property not found");
+            return GetProperty<T>(ResolveProperty(instance, propertyName), instance);
         }
 
         /**
@@ -268,77 +512,39 @@ namespace Radium::Nodes
         template <typename T>
         T *GetPropertyPointer(std::string propertyName, Object *instance)
         {
-            std::string typeName = Demangle(typeid(*instance).name());
-            ClassInfo *info = &registeredClasses[typeName];
-
-            while (info)
-            {
-                for (const PropertyInfo &prop : info->properties)
-                {
-                    if (prop.name == propertyName)
-                    {
-                        if (prop.size != sizeof(T))
-                        {
-                            throw std::runtime_error("Property size mismatch");
-                        }
-
-                        uint8_t *basePtr = reinterpret_cast<uint8_t *>(instance);
-                        return reinterpret_cast<T *>(basePtr + prop.offset);
-                    }
-                }
-                info = info->parent;
-            }
-
-            throw std::runtime_error("Property not found");
+            return GetPropertyPointer<T>(ResolveProperty(instance, propertyName), instance);
         }
 
         /**
          * @brief Get class information for a given object instance.
          *
          * @param object Pointer to the object instance
-         * @return ClassInfo Class information structure
+         * @return ClassInfo& Class information structure, an empty entry if the class is not registered
          */
-        inline ClassInfo GetClassInfo(Object *object)
+        inline ClassInfo &GetClassInfo(Object *object)
         {
-            return registeredClasses[Demangle(typeid(*object).name())];
+            ClassInfo *info = FindClass(object);
+            return info ? *info : registeredClasses[GetTypeName(typeid(*object))];
         }
 
         /**
          * @brief Get all properties of an object instance, including inherited ones.
          *
          * @param instance Pointer to the object instance
-         * @return std::vector<PropertyInfo> List of property info structures
+         * @return const std::vector<PropertyInfo>& List of property info structures, valid until more properties are registered
          * @throws std::runtime_error If class is not registered
          */
-        inline std::vector<PropertyInfo> GetProperties(Object *instance)
+        inline const std::vector<PropertyInfo> &GetProperties(Object *instance)
         {
-            std::vector<PropertyInfo> result;
-
-            std::string typeName = Demangle(typeid(*instance).name());
-
-            auto it = registeredClasses.find(typeName);
-            if (it == registeredClasses.end())
-            {
-                throw std::runtime_error("Type not registered: " + typeName);
-            }
-
-            ClassInfo *info = &it->second;
-
-            // Walk the inheritance chain, deepest base first
-            std::vector<ClassInfo *> classChain;
-            while (info)
-            {
-                classChain.insert(classChain.begin(), info);
-                info = info->parent;
-            }
-
-            // Collect properties from base to derived
-            for (ClassInfo *cls : classChain)
+            ClassInfo *info = FindClass(instance);
+            if (!info)
             {
-                result.insert(result.end(), cls->properties.begin(), cls->properties.end());
+                throw std::runtime_error("Type not registered: " + GetTypeName(typeid(*instance)));
             }
 
-            return result;
+            // Flattened once per class, deepest base first
+            BuildPropertyLookup(info);
+            return info->allProperties;
         }
 
         /**
@@ -356,44 +562,34 @@ namespace Radium::Nodes
                 return nullptr;
             }
 
-            std::string typeName = Radium::Nodes::Demangle(typeid(*instance).name());
-            auto it = Radium::Nodes::ClassDB::registeredClasses.find(typeName);
-
-            if (it == Radium::Nodes::ClassDB::registeredClasses.end())
+            ClassInfo *info = FindClass(instance);
+            if (!info)
             {
-                Flux::Error("Class not registered: {}", typeName);
+                Flux::Error("Class not registered: {}", GetTypeName(typeid(*instance)));
                 return nullptr;
             }
 
-            Radium::Nodes::ClassDB::ClassInfo *info = &it->second;
-
-            while (info)
+            PropertyId id = ResolveProperty(info, propertyName);
+            if (!id)
             {
-                for (const auto &prop : info->properties)
-                {
-                    if (prop.name == propertyName)
-                    {
-                        // Return pointer to sub-object
-                        uint8_t *base = reinterpret_cast<uint8_t *>(instance);
-                        Object *subObj = reinterpret_cast<Object *>(base + prop.offset);
-                        return subObj;
-                    }
-                }
-                info = info->parent;
+                return nullptr;
             }
 
-            return nullptr;
+            // Return pointer to sub-object
+            uint8_t *base = reinterpret_cast<uint8_t *>(instance);
+            return reinterpret_cast<Object *>(base + id.offset);
         }
 
         /**
         * @brief Get the demangled type name of an object instance.
         *
         * @param object Pointer to the object instance
-        * @return std::string Demangled type name
+        * @return const std::string& Demangled type name
         */
-        inline std::string GetType(Object *object)
+        inline const std::string &GetType(Object *object)
         {
-            return Demangle(typeid(*object).name());
+            ClassInfo *info = FindClass(object);
+            return info ? info->name : GetTypeName(typeid(*object));
         }
 
         /**
@@ -463,29 +659,13 @@ namespace Radium::Nodes
         */
         inline bool HasProperty(std::string propertyName, Object *obj)
         {
-            std::string typeName = ClassDB::GetType(obj);
-
-            auto it = registeredClasses.find(typeName);
-            if (it == registeredClasses.end())
+            ClassInfo *info = FindClass(obj);
+            if (!info)
             {
-                throw std::runtime_error("Type not registered: " + typeName);
-            }
-
-            ClassInfo *info = &it->second;
-
-            while (info)
-            {
-                for (const auto &prop : info->properties)
-                {
-                    if (prop.name == propertyName)
-                    {
-                        return true;
-                    }
-                }
-                info = info->parent;
+                throw std::runtime_error("Type not registered: " + GetTypeName(typeid(*obj)));
             }
 
-            return false;
+            return ResolveProperty(info, propertyName).valid;
         }
 
     }
@@ -0,0 +1,292 @@
+#include <Radium/Nodes/LuaMemory.hpp>
+#include <Radium/Nodes/LuaScript.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace Radium::Nodes
+{
+    LuaMemory::~LuaMemory()
+    {
+        for (void *page : pages)
+        {
+            std::free(page);
+        }
+    }
+
+    void *LuaMemory::Alloc(void *ud, void *ptr, size_t osize, size_t nsize)
+    {
+        LuaMemory *memory = static_cast<LuaMemory *>(ud);
+
+        if (nsize == 0)
+        {
+            if (ptr)
+            {
+                memory->Free(ptr, osize);
+            }
+            return nullptr;
+        }
+
+        // Without a block, osize is the type of object being created
+        if (!ptr)
+        {
+            return memory->Allocate(nsize, memory->GetCurrentAccount());
+        }
+
+        return memory->Reallocate(ptr, osize, nsize);
+    }
+
+    void LuaMemory::Attach(lua_State *L)
+    {
+        this->L = L;
+
+        switch (gcMode)
+        {
+        case LuaGcMode::Generational:
+            lua_gc(L, LUA_GCGEN, 0, 0);
+            break;
+        case LuaGcMode::Stepped:
+            lua_gc(L, LUA_GCINC, 0, 0, 0);
+            lua_gc(L, LUA_GCSTOP);
+            break;
+        default:
+            lua_gc(L, LUA_GCINC, 0, 0, 0);
+            break;
+        }
+    }
+
+    void LuaMemory::Step()
+    {
+        if (!L || gcMode != LuaGcMode::Stepped)
+        {
+            return;
+        }
+
+        // Do at least as much work as was allocated, or garbage would pile up over time
+        int kb = std::max(stepKb, (int)(allocatedSinceStep / 1024));
+        allocatedSinceStep = 0;
+        lua_gc(L, LUA_GCSTEP, kb);
+    }
+
+    uint32_t LuaMemory::GetAccount(const std::string &path)
+    {
+        auto it = accountsByPath.find(path);
+        if (it != accountsByPath.end())
+        {
+            return it->second;
+        }
+
+        uint32_t account = (uint32_t)accounts.size();
+        accounts.emplace_back();
+        accountsByPath.emplace(path, account);
+        return account;
+    }
+
+    size_t LuaMemory::GetBytes() const
+    {
+        return bytes;
+    }
+
+    size_t LuaMemory::GetScriptBytes(const std::string &path) const
+    {
+        auto it = accountsByPath.find(path);
+        return it != accountsByPath.end() ? accounts[it->second].bytes : 0;
+    }
+
+    void LuaMemory::Clear()
+    {
+        for (void *page : pages)
+        {
+            std::free(page);
+        }
+        pages.clear();
+        std::fill(std::begin(freeBlocks), std::end(freeBlocks), nullptr);
+        pageCursor = nullptr;
+        pageEnd = nullptr;
+
+        accounts.assign(1, Account());
+        accountsByPath.clear();
+        bytes = 0;
+        allocatedSinceStep = 0;
+        L = nullptr;
+    }
+
+    void *LuaMemory::Allocate(size_t size, uint32_t account)
+    {
+        if (!Fits(account, size))
+        {
+            return nullptr;
+        }
+
+        char *block = static_cast<char *>(AllocateBlock(size + headerSize));
+        if (!block)
+        {
+            return nullptr;
+        }
+
+        std::memcpy(block, &account, sizeof(account));
+        block[pooledOffset] = GetClass(size + headerSize) < classCount;
+        accounts[account].bytes += size;
+        bytes += size;
+        allocatedSinceStep += size;
+        return block + headerSize;
+    }
+
+    void LuaMemory::Free(void *ptr, size_t size)
+    {
+        char *block = static_cast<char *>(ptr) - headerSize;
+
+        uint32_t account;
+        std::memcpy(&account, block, sizeof(account));
+        accounts[account].bytes -= size;
+        bytes -= size;
+
+        if (IsPooled(block))
+        {
+            FreeBlock(block, size + headerSize);
+        }
+        else
+        {
+            std::free(block);
+        }
+    }
+
+    void *LuaMemory::Reallocate(void *ptr, size_t oldSize, size_t newSize)
+    {
+        char *block = static_cast<char *>(ptr) - headerSize;
+
+        // The block stays charged to whoever allocated it
+        uint32_t account;
+        std::memcpy(&account, block, sizeof(account));
+
+        if (newSize > oldSize && !Fits(account, newSize - oldSize))
+        {
+            return nullptr;
+        }
+
+        size_t oldClass = GetClass(oldSize + headerSize);
+        size_t newClass = GetClass(newSize + headerSize);
+
+        bool pooled = IsPooled(block);
+
+        char *moved;
+        if (pooled && oldClass == newClass)
+        {
+            // Still fits the same pooled slot
+            moved = block;
+        }
+        else if (!pooled && newClass >= classCount)
+        {
+            moved = static_cast<char *>(std::realloc(block, newSize + headerSize));
+        }
+        else
+        {
+            moved = static_cast<char *>(AllocateBlock(newSize + headerSize));
+            if (moved)
+            {
+                std::memcpy(moved, block, std::min(oldSize, newSize) + headerSize);
+                moved[pooledOffset] = newClass < classCount;
+                if (pooled)
+                {
+                    FreeBlock(block, oldSize + headerSize);
+                }
+                else
+                {
+                    std::free(block);
+                }
+            }
+            else if (newSize <= oldSize)
+            {
+                // Lua expects a shrink to never fail. A pooled block is kept and later freed into
+                // the new class, which it is big enough for, a malloc one is shrunk in place and
+                // stays marked as not pooled
+                moved = pooled ? block : static_cast<char *>(std::realloc(block, newSize + headerSize));
+            }
+        }
+
+        if (!moved)
+        {
+            return nullptr;
+        }
+
+        accounts[account].bytes = accounts[account].bytes - oldSize + newSize;
+        bytes = bytes - oldSize + newSize;
+        if (newSize > oldSize)
+        {
+            allocatedSinceStep += newSize - oldSize;
+        }
+        return moved + headerSize;
+    }
+
+    bool LuaMemory::Fits(uint32_t account, size_t extra) const
+    {
+        if (limit > 0 && bytes + extra > limit)
+        {
+            return false;
+        }
+
+        return scriptLimit == 0 || account == 0 || accounts[account].bytes + extra <= scriptLimit;
+    }
+
+    void *LuaMemory::AllocateBlock(size_t size)
+    {
+        size_t sizeClass = GetClass(size);
+        if (sizeClass >= classCount)
+        {
+            return std::malloc(size);
+        }
+
+        if (void *block = freeBlocks[sizeClass])
+        {
+            std::memcpy(&freeBlocks[sizeClass], block, sizeof(void *));
+            return block;
+        }
+
+        size_t blockSize = (sizeClass + 1) * classGranularity;
+        if (!pageCursor || pageCursor + blockSize > pageEnd)
+        {
+            // What is left of the old page is too small for this class and stays unused
+            char *page = static_cast<char *>(std::malloc(pageSize));
+            if (!page)
+            {
+                return nullptr;
+            }
+
+            pages.push_back(page);
+            pageCursor = page;
+            pageEnd = page + pageSize;
+        }
+
+        void *block = pageCursor;
+        pageCursor += blockSize;
+        return block;
+    }
+
+    void LuaMemory::FreeBlock(void *block, size_t size)
+    {
+        size_t sizeClass = GetClass(size);
+        if (sizeClass >= classCount)
+        {
+            std::free(block);
+            return;
+        }
+
+        std::memcpy(block, &freeBlocks[sizeClass], sizeof(void *));
+        freeBlocks[sizeClass] = block;
+    }
+
+    bool LuaMemory::IsPooled(const char *block)
+    {
+        return block[pooledOffset] != 0;
+    }
+
+    uint32_t LuaMemory::GetCurrentAccount() const
+    {
+        return Lua::runningScript ? Lua::runningScript->memoryAccount : 0;
+    }
+
+    size_t LuaMemory::GetClass(size_t size)
+    {
+        return (size + classGranularity - 1) / classGranularity - 1;
+    }
+}
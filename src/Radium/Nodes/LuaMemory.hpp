@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include <lua.h>
+}
+
+namespace Radium::Nodes {
+    /**
+     * @brief How the garbage collector of the shared state is driven
+     */
+    enum class LuaGcMode {
+        /// Lua's default, collection steps run whenever scripts allocate
+        Incremental,
+        /// Young objects are collected often and cheaply, old ones rarely
+        Generational,
+        /// Automatic collection is stopped, Step() does the work at a fixed point in the frame
+        Stepped
+    };
+
+    /**
+     * @brief Allocator of the shared Lua state, with per-script accounting and limits
+     *
+     * Small blocks come from pooled pages split into size classes, larger ones from malloc.
+     * Every block remembers the script that allocated it, so memory is charged to that script
+     * until the block is freed, no matter which script is running when the collector frees it.
+     * Scripts are accounted by path, instances of the same script share one account.
+     */
+    class LuaMemory {
+    public:
+        /**
+         * @brief How the collector runs, applied when the state is created
+         */
+        LuaGcMode gcMode = LuaGcMode::Incremental;
+
+        /**
+         * @brief Minimum amount of work in KB done by each Step() in stepped mode
+         *
+         * A step also covers what was allocated since the last one, so the collector keeps up.
+         */
+        int stepKb = 64;
+
+        /**
+         * @brief Bytes a single script may hold, 0 for no limit
+         *
+         * Allocations over the limit fail, which raises a memory error in the script after
+         * Lua has tried a full collection.
+         */
+        size_t scriptLimit = 0;
+
+        /**
+         * @brief Bytes all scripts together may hold, 0 for no limit
+         */
+        size_t limit = 0;
+
+        ~LuaMemory();
+
+        /**
+         * @brief lua_Alloc for lua_newstate, with a LuaMemory as userdata
+         */
+        static void* Alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+        /**
+         * @brief Apply the collector mode to a state created with Alloc
+         */
+        void Attach(lua_State* L);
+
+        /**
+         * @brief Run one bounded collection step, only does something in stepped mode
+         *
+         * Called once per frame by the Application, so collections never land in the middle
+         * of script callbacks.
+         */
+        void Step();
+
+        /**
+         * @brief Get the account of a script, created on first use
+         *
+         * @param path Path of the script
+         * @return Account to charge while the script runs
+         */
+        uint32_t GetAccount(const std::string& path);
+
+        /**
+         * @brief Get the bytes held by every script
+         */
+        size_t GetBytes() const;
+
+        /**
+         * @brief Get the bytes held by one script, 0 if it never allocated
+         */
+        size_t GetScriptBytes(const std::string& path) const;
+
+        /**
+         * @brief Release the pooled pages and accounts, for after the state is closed
+         */
+        void Clear();
+
+    private:
+        struct Account {
+            size_t bytes = 0;
+        };
+
+        // Every block starts with the account it is charged to, followed by whether it came
+        // from a pooled page, Lua only needs 8 byte alignment
+        static constexpr size_t headerSize = 8;
+        static constexpr size_t pooledOffset = sizeof(uint32_t);
+        static constexpr size_t classGranularity = 16;
+        static constexpr size_t classCount = 16;
+        static constexpr size_t pageSize = 64 * 1024;
+
+        lua_State* L = nullptr;
+
+        /// Account 0 is for allocations made while no script is running
+        std::vector<Account> accounts = std::vector<Account>(1);
+        std::unordered_map<std::string, uint32_t> accountsByPath;
+        size_t bytes = 0;
+        size_t allocatedSinceStep = 0;
+
+        /// Free blocks of each size class, linked through their first bytes
+        void* freeBlocks[classCount] = {};
+        std::vector<void*> pages;
+        char* pageCursor = nullptr;
+        char* pageEnd = nullptr;
+
+        void* Allocate(size_t size, uint32_t account);
+        void Free(void* ptr, size_t size);
+        void* Reallocate(void* ptr, size_t oldSize, size_t newSize);
+        bool Fits(uint32_t account, size_t extra) const;
+        void* AllocateBlock(size_t size);
+        void FreeBlock(void* block, size_t size);
+        static bool IsPooled(const char* block);
+        uint32_t GetCurrentAccount() const;
+
+        static size_t GetClass(size_t size);
+    };
+}
@@ -0,0 +1,231 @@
+#include <Radium/Nodes/LuaProfiler.hpp>
+#include <Radium/Nodes/LuaScript.hpp>
+#include <tracy/Tracy.hpp>
+#include <imgui.h>
+#include <algorithm>
+
+namespace Radium::Nodes
+{
+    // Weight of the newest frame in the averages
+    static constexpr double averageWeight = 0.1;
+    // Functions whose average drops below this are forgotten
+    static constexpr double forgetMs = 0.0001;
+
+    static double elapsed_ms(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    void LuaProfiler::Attach(lua_State *L)
+    {
+        if (enabled)
+        {
+            lua_sethook(L, Hook, LUA_MASKCOUNT, std::max(sampleInterval, 1));
+        }
+    }
+
+    void LuaProfiler::Begin(const std::string &script)
+    {
+        if (!enabled)
+        {
+            return;
+        }
+
+        Clock::time_point now = Clock::now();
+        if (!stack.empty())
+        {
+            // The outer script pauses while this one runs
+            stack.back().stats->frameMs += elapsed_ms(stack.back().start, now);
+        }
+
+        ScriptStats &stats = scripts[script];
+        if (!stats.plotName)
+        {
+            stats.plotName = plotNames.insert("Lua " + script).first->c_str();
+        }
+        stats.frameCalls++;
+
+        stack.push_back({&stats, now});
+        lastSample = now;
+    }
+
+    void LuaProfiler::End()
+    {
+        if (!enabled || stack.empty())
+        {
+            return;
+        }
+
+        Clock::time_point now = Clock::now();
+        double ms = elapsed_ms(stack.back().start, now);
+        stack.back().stats->frameMs += ms;
+        frameMs += ms;
+        stack.pop_back();
+
+        if (!stack.empty())
+        {
+            stack.back().start = now;
+        }
+        lastSample = now;
+    }
+
+    void LuaProfiler::EndFrame()
+    {
+        if (!enabled)
+        {
+            return;
+        }
+
+        averageMs += (frameMs - averageMs) * averageWeight;
+        TracyPlot("Lua", frameMs);
+        TracyPlot("Lua KB", (double)Lua::memory.GetBytes() / 1024.0);
+        frameMs = 0.0;
+
+        for (auto &[script, stats] : scripts)
+        {
+            stats.averageMs += (stats.frameMs - stats.averageMs) * averageWeight;
+        }
+
+#ifdef TRACY_ENABLE
+        for (const auto *entry : Top(scripts))
+        {
+            TracyPlot(entry->second.plotName, entry->second.frameMs);
+        }
+#endif
+
+        for (auto &[script, stats] : scripts)
+        {
+            stats.lastCalls = stats.frameCalls;
+            stats.frameMs = 0.0;
+            stats.frameCalls = 0;
+        }
+
+        for (auto it = functions.begin(); it != functions.end();)
+        {
+            FunctionStats &stats = it->second;
+            stats.averageMs += (stats.frameMs - stats.averageMs) * averageWeight;
+            stats.frameMs = 0.0;
+
+            if (stats.averageMs < forgetMs)
+            {
+                it = functions.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void LuaProfiler::DrawImgui()
+    {
+        if (!enabled)
+        {
+            return;
+        }
+
+        ImGui::Begin("Lua Profiler");
+        ImGui::Text("Scripts: %.3f ms per frame, %.1f KB", averageMs, (double)Lua::memory.GetBytes() / 1024.0);
+
+        ImGui::Separator();
+        if (ImGui::BeginTable("Scripts", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+        {
+            ImGui::TableSetupColumn("Script");
+            ImGui::TableSetupColumn("ms");
+            ImGui::TableSetupColumn("Calls");
+            ImGui::TableSetupColumn("KB");
+            ImGui::TableHeadersRow();
+
+            for (const auto *entry : Top(scripts))
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", entry->first.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", entry->second.averageMs);
+                ImGui::TableNextColumn();
+                ImGui::Text("%llu", (unsigned long long)entry->second.lastCalls);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", (double)Lua::memory.GetScriptBytes(entry->first) / 1024.0);
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::Separator();
+        if (ImGui::BeginTable("Functions", 2, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+        {
+            ImGui::TableSetupColumn("Function");
+            ImGui::TableSetupColumn("ms");
+            ImGui::TableHeadersRow();
+
+            for (const auto *entry : Top(functions))
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::Text("%s", entry->second.name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.3f", entry->second.averageMs);
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::End();
+    }
+
+    void LuaProfiler::Clear()
+    {
+        scripts.clear();
+        functions.clear();
+        stack.clear();
+        frameMs = 0.0;
+        averageMs = 0.0;
+    }
+
+    void LuaProfiler::Sample(lua_State *L, lua_Debug *ar)
+    {
+        if (stack.empty())
+        {
+            // Not started by a script, like a finalizer running during collection
+            return;
+        }
+
+        Clock::time_point now = Clock::now();
+        double ms = elapsed_ms(lastSample, now);
+        lastSample = now;
+
+        if (!lua_getinfo(L, "Sn", ar))
+        {
+            return;
+        }
+
+        std::string key = std::string(ar->short_src) + ":" + std::to_string(ar->linedefined);
+        FunctionStats &stats = functions[key];
+        if (stats.name.empty())
+        {
+            stats.name = ar->name ? std::string(ar->name) + " (" + key + ")" : key;
+        }
+        stats.frameMs += ms;
+    }
+
+    void LuaProfiler::Hook(lua_State *L, lua_Debug *ar)
+    {
+        Lua::profiler.Sample(L, ar);
+    }
+
+    template <typename T>
+    std::vector<const std::pair<const std::string, T> *> LuaProfiler::Top(const std::unordered_map<std::string, T> &stats) const
+    {
+        std::vector<const std::pair<const std::string, T> *> top;
+        top.reserve(stats.size());
+        for (const auto &entry : stats)
+        {
+            top.push_back(&entry);
+        }
+
+        size_t count = std::min(topCount, top.size());
+        std::partial_sort(top.begin(), top.begin() + count, top.end(), [](const auto *a, const auto *b)
+                          { return a->second.averageMs > b->second.averageMs; });
+        top.resize(count);
+        return top;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+extern "C" {
+#include <lua.h>
+}
+
+namespace Radium::Nodes {
+    /**
+     * @brief Measures how much CPU time scripts spend, per script and per Lua function
+     *
+     * Time between Begin() and End() is charged to a script, nested calls only count towards
+     * the innermost one. Inside them, a count hook samples the running function every
+     * sampleInterval instructions and charges it the time since the previous sample.
+     * Totals are kept per frame, smoothed, and shown as Tracy plots and in an ImGui window.
+     */
+    class LuaProfiler {
+    public:
+        /**
+         * @brief Whether scripts are measured, enabled by the `--profile-scripts` argument
+         *
+         * Has to be set before the first script is loaded, the hook is installed with the state.
+         */
+        bool enabled = false;
+
+        /**
+         * @brief Number of Lua instructions between two function samples
+         */
+        int sampleInterval = 1000;
+
+        /**
+         * @brief Number of scripts and functions shown in the window and plotted in Tracy
+         */
+        size_t topCount = 8;
+
+        /**
+         * @brief Install the sampling hook into a state, coroutines created from it inherit it
+         */
+        void Attach(lua_State* L);
+
+        /**
+         * @brief Start charging time to a script
+         *
+         * @param script Path of the script about to run
+         */
+        void Begin(const std::string& script);
+
+        /**
+         * @brief Stop charging time to the script of the matching Begin()
+         */
+        void End();
+
+        /**
+         * @brief Close the current frame, updating the averages and the Tracy plots
+         */
+        void EndFrame();
+
+        /**
+         * @brief Draw the window listing the most expensive scripts and functions
+         */
+        void DrawImgui();
+
+        /**
+         * @brief Forget every measurement, for when the state is closed
+         */
+        void Clear();
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct ScriptStats {
+            double frameMs = 0.0;
+            double averageMs = 0.0;
+            uint64_t frameCalls = 0;
+            uint64_t lastCalls = 0;
+            /// Points into plotNames
+            const char* plotName = nullptr;
+        };
+
+        struct FunctionStats {
+            std::string name;
+            double frameMs = 0.0;
+            double averageMs = 0.0;
+        };
+
+        struct Frame {
+            ScriptStats* stats;
+            Clock::time_point start;
+        };
+
+        std::unordered_map<std::string, ScriptStats> scripts;
+        /// Keyed by source and line the function is defined on
+        std::unordered_map<std::string, FunctionStats> functions;
+        std::vector<Frame> stack;
+        /// Tracy keeps plot name pointers for the whole program, so these outlive Clear
+        std::unordered_set<std::string> plotNames;
+        Clock::time_point lastSample;
+
+        double frameMs = 0.0;
+        double averageMs = 0.0;
+
+        void Sample(lua_State* L, lua_Debug* ar);
+        static void Hook(lua_State* L, lua_Debug* ar);
+
+        template <typename T>
+        std::vector<const std::pair<const std::string, T>*> Top(const std::unordered_map<std::string, T>& stats) const;
+    };
+}
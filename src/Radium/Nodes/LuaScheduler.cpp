@@ -0,0 +1,379 @@
+#include <Radium/Nodes/LuaScheduler.hpp>
+#include <Radium/Nodes/LuaScript.hpp>
+#include <Flux/Flux.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace Radium::Nodes
+{
+    /// What a coroutine yielded for, pushed by the wait functions
+    enum WaitKind
+    {
+        WaitNextTick,
+        WaitSeconds,
+        WaitFrames,
+        WaitUntil
+    };
+
+    // Yielded first by the wait functions, so a plain coroutine.yield() is never mistaken for one
+    static char waitMarker;
+
+    static int yield_wait(lua_State *L, WaitKind kind)
+    {
+        if (!lua_isyieldable(L))
+        {
+            return luaL_error(L, "Waiting is only possible inside a coroutine, start one with spawn");
+        }
+
+        lua_pushlightuserdata(L, &waitMarker);
+        lua_pushinteger(L, kind);
+        lua_pushvalue(L, 1);
+        return lua_yield(L, 3);
+    }
+
+    static int lua_spawn(lua_State *L)
+    {
+        luaL_checktype(L, 1, LUA_TFUNCTION);
+
+        // Every coroutine belongs to a script, outside one (e.g. in a __gc finalizer) there is nothing to own it
+        if (!Lua::runningScript)
+        {
+            return luaL_error(L, "spawn can only be called while a script is running");
+        }
+
+        Lua::scheduler.Start(L, Lua::runningScript, lua_gettop(L) - 1);
+        return 0;
+    }
+
+    static int lua_wait(lua_State *L)
+    {
+        luaL_checknumber(L, 1);
+        return yield_wait(L, WaitSeconds);
+    }
+
+    static int lua_wait_frames(lua_State *L)
+    {
+        luaL_checkinteger(L, 1);
+        return yield_wait(L, WaitFrames);
+    }
+
+    static int lua_wait_until(lua_State *L)
+    {
+        luaL_checktype(L, 1, LUA_TFUNCTION);
+        return yield_wait(L, WaitUntil);
+    }
+
+    void LuaScheduler::RegisterGlobals(lua_State *L)
+    {
+        lua_register(L, "spawn", lua_spawn);
+        lua_register(L, "wait", lua_wait);
+        lua_register(L, "waitFrames", lua_wait_frames);
+        lua_register(L, "waitUntil", lua_wait_until);
+    }
+
+    void LuaScheduler::Start(lua_State *L, LuaScript *owner, int argCount, const char *event)
+    {
+        if (!this->L)
+        {
+            lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+            this->L = lua_tothread(L, -1);
+            lua_pop(L, 1);
+        }
+
+        Routine routine;
+        routine.owner = owner;
+        routine.thread = lua_newthread(L);
+
+        // Move the function and its arguments over to the new thread
+        lua_insert(L, -(argCount + 2));
+        lua_xmove(L, routine.thread, argCount + 1);
+        routine.threadRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
+        Resume(routine, argCount, event);
+    }
+
+    void LuaScheduler::Update(float dt)
+    {
+        if (!L)
+        {
+            return;
+        }
+
+        tick++;
+        time += dt;
+        if (dt > 0.0f)
+        {
+            lastDt = dt;
+        }
+
+        // Whatever missed the last budget goes first
+        std::vector<Routine> due;
+        due.swap(deferred);
+
+        std::vector<Routine> slot;
+        slot.swap(wheel[tick % wheelSize]);
+        for (Routine &routine : slot)
+        {
+            if (routine.dueTick > tick)
+            {
+                // A later round of the wheel
+                wheel[tick % wheelSize].push_back(routine);
+            }
+            else if (routine.dueTime > time)
+            {
+                // Ticks were shorter than estimated, check again when it should be due
+                uint64_t ticks = (uint64_t)std::ceil((routine.dueTime - time) / lastDt);
+                Schedule(routine, tick + std::max<uint64_t>(ticks, 1));
+            }
+            else
+            {
+                due.push_back(routine);
+            }
+        }
+
+        // Predicates may destroy scripts, so work on a copy Cancel can see
+        std::vector<Routine> checking;
+        checking.swap(polling);
+        resuming = &checking;
+        for (Routine &routine : checking)
+        {
+            if (!routine.thread)
+            {
+                continue;
+            }
+
+            LuaScript *previous = Lua::runningScript;
+            Lua::runningScript = routine.owner;
+            Lua::profiler.Begin(routine.owner->path);
+
+            lua_rawgeti(L, LUA_REGISTRYINDEX, routine.predicateRef);
+            int result = lua_pcall(L, 0, 1, 0);
+
+            Lua::profiler.End();
+            Lua::runningScript = previous;
+
+            if (!routine.thread)
+            {
+                // Cancelled by its own predicate
+                lua_pop(L, 1);
+                continue;
+            }
+
+            if (result != LUA_OK)
+            {
+                Flux::Error("Lua waitUntil error: {}", lua_tostring(L, -1));
+                lua_pop(L, 1);
+                Release(routine);
+                routine.thread = nullptr;
+                continue;
+            }
+
+            bool ready = lua_toboolean(L, -1);
+            lua_pop(L, 1);
+
+            if (ready)
+            {
+                luaL_unref(L, LUA_REGISTRYINDEX, routine.predicateRef);
+                routine.predicateRef = LUA_NOREF;
+                due.push_back(routine);
+            }
+            else
+            {
+                polling.push_back(routine);
+            }
+            routine.thread = nullptr;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        resuming = &due;
+        size_t index = 0;
+        for (; index < due.size(); index++)
+        {
+            if (budgetMs > 0.0f && index > 0)
+            {
+                std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                if (elapsed.count() > budgetMs)
+                {
+                    break;
+                }
+            }
+
+            if (!due[index].thread)
+            {
+                continue;
+            }
+
+            Routine routine = due[index];
+            due[index].thread = nullptr;
+            Resume(routine, 0, "coroutine");
+        }
+        resuming = nullptr;
+
+        for (; index < due.size(); index++)
+        {
+            if (due[index].thread)
+            {
+                deferred.push_back(due[index]);
+            }
+        }
+    }
+
+    void LuaScheduler::Cancel(LuaScript *owner)
+    {
+        if (!L)
+        {
+            return;
+        }
+
+        for (auto &slot : wheel)
+        {
+            CancelIn(slot, owner);
+        }
+        CancelIn(polling, owner);
+        CancelIn(deferred, owner);
+
+        if (resuming)
+        {
+            // Update still holds these, mark them instead of erasing
+            for (Routine &routine : *resuming)
+            {
+                if (routine.thread && routine.owner == owner)
+                {
+                    Release(routine);
+                    routine.thread = nullptr;
+                }
+            }
+        }
+
+        if (resumeDepth > 0)
+        {
+            cancelledOwners.push_back(owner);
+        }
+    }
+
+    void LuaScheduler::Clear()
+    {
+        for (auto &slot : wheel)
+        {
+            slot.clear();
+        }
+        polling.clear();
+        deferred.clear();
+        cancelledOwners.clear();
+        L = nullptr;
+    }
+
+    size_t LuaScheduler::GetCount() const
+    {
+        size_t count = polling.size() + deferred.size();
+        for (const auto &slot : wheel)
+        {
+            count += slot.size();
+        }
+        return count;
+    }
+
+    void LuaScheduler::Resume(Routine routine, int argCount, const char *event)
+    {
+        LuaScript *previous = Lua::runningScript;
+        Lua::runningScript = routine.owner;
+        Lua::profiler.Begin(routine.owner->path);
+        resumeDepth++;
+
+        int resultCount = 0;
+        int status = lua_resume(routine.thread, L, argCount, &resultCount);
+
+        resumeDepth--;
+        Lua::profiler.End();
+        Lua::runningScript = previous;
+
+        bool cancelled = std::find(cancelledOwners.begin(), cancelledOwners.end(), routine.owner) != cancelledOwners.end();
+        if (resumeDepth == 0)
+        {
+            cancelledOwners.clear();
+        }
+
+        if (status == LUA_YIELD && !cancelled)
+        {
+            Park(routine, resultCount);
+            return;
+        }
+
+        if (status != LUA_OK && status != LUA_YIELD)
+        {
+            Flux::Error("Lua {} error: {}", event, lua_tostring(routine.thread, -1));
+        }
+
+        Release(routine);
+    }
+
+    void LuaScheduler::Park(Routine routine, int resultCount)
+    {
+        lua_State *thread = routine.thread;
+        int first = lua_gettop(thread) - resultCount + 1;
+
+        WaitKind kind = WaitNextTick;
+        if (resultCount == 3 && lua_touserdata(thread, first) == &waitMarker)
+        {
+            kind = (WaitKind)lua_tointeger(thread, first + 1);
+        }
+
+        uint64_t dueTick = tick + 1;
+        switch (kind)
+        {
+        case WaitSeconds:
+        {
+            double seconds = lua_tonumber(thread, first + 2);
+            routine.dueTime = time + seconds;
+            dueTick = tick + std::max<uint64_t>((uint64_t)std::ceil(std::max(seconds, 0.0) / lastDt), 1);
+            break;
+        }
+        case WaitFrames:
+            dueTick = tick + (uint64_t)std::max<lua_Integer>(lua_tointeger(thread, first + 2), 1);
+            break;
+        case WaitUntil:
+            lua_pushvalue(thread, first + 2);
+            lua_xmove(thread, L, 1);
+            routine.predicateRef = luaL_ref(L, LUA_REGISTRYINDEX);
+            lua_pop(thread, resultCount);
+            polling.push_back(routine);
+            return;
+        default:
+            break;
+        }
+
+        lua_pop(thread, resultCount);
+        Schedule(routine, dueTick);
+    }
+
+    void LuaScheduler::Schedule(Routine routine, uint64_t dueTick)
+    {
+        routine.dueTick = dueTick;
+        wheel[dueTick % wheelSize].push_back(routine);
+    }
+
+    void LuaScheduler::Release(Routine &routine)
+    {
+        luaL_unref(L, LUA_REGISTRYINDEX, routine.predicateRef);
+        luaL_unref(L, LUA_REGISTRYINDEX, routine.threadRef);
+        routine.predicateRef = LUA_NOREF;
+        routine.threadRef = LUA_NOREF;
+    }
+
+    void LuaScheduler::CancelIn(std::vector<Routine> &routines, LuaScript *owner)
+    {
+        for (Routine &routine : routines)
+        {
+            if (routine.owner == owner)
+            {
+                Release(routine);
+            }
+        }
+
+        routines.erase(std::remove_if(routines.begin(), routines.end(), [owner](const Routine &routine)
+                                      { return routine.owner == owner; }),
+                       routines.end());
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+namespace Radium::Nodes {
+    class LuaScript;
+
+    /**
+     * @brief Runs script coroutines and resumes them once what they wait for is due
+     *
+     * Coroutines started with spawn() in Lua can call wait(seconds), waitFrames(n) and
+     * waitUntil(fn). Waiting coroutines are parked in a timer wheel indexed by tick, so an
+     * update only touches the ones that are due instead of every waiting script.
+     */
+    class LuaScheduler {
+    public:
+        /**
+         * @brief Time in milliseconds Update() may spend resuming coroutines, 0 for no limit
+         *
+         * Coroutines that do not fit are resumed first on the next tick. At least one coroutine
+         * is always resumed so every one of them keeps making progress.
+         */
+        float budgetMs = 0.0f;
+
+        /**
+         * @brief Start a coroutine and run it until it first waits or returns
+         *
+         * @param L State with the function and its arguments on top of the stack, they are popped.
+         * @param owner Script the coroutine belongs to, it is cancelled when the script is destroyed
+         * @param argCount Number of arguments above the function
+         * @param event Name used when logging errors
+         */
+        void Start(lua_State* L, LuaScript* owner, int argCount, const char* event = "coroutine");
+
+        /**
+         * @brief Advance one tick and resume the coroutines that are due
+         *
+         * @param dt Delta time of the tick
+         */
+        void Update(float dt);
+
+        /**
+         * @brief Drop every coroutine belonging to a script
+         */
+        void Cancel(LuaScript* owner);
+
+        /**
+         * @brief Forget every coroutine without touching Lua, for when the state is closed
+         */
+        void Clear();
+
+        /**
+         * @brief Get the number of coroutines that are waiting
+         */
+        size_t GetCount() const;
+
+        /**
+         * @brief Register spawn, wait, waitFrames and waitUntil into a state's globals
+         */
+        static void RegisterGlobals(lua_State* L);
+
+    private:
+        struct Routine {
+            lua_State* thread = nullptr;
+            int threadRef = LUA_NOREF;
+            LuaScript* owner = nullptr;
+            uint64_t dueTick = 0;
+            /// Time the coroutine wakes at for wait(seconds), the tick is only an estimate then
+            double dueTime = 0.0;
+            /// waitUntil predicate, LUA_NOREF otherwise
+            int predicateRef = LUA_NOREF;
+        };
+
+        static constexpr size_t wheelSize = 256;
+
+        lua_State* L = nullptr;
+        uint64_t tick = 0;
+        double time = 0.0;
+        float lastDt = 1.0f / 60.0f;
+
+        /// Routines by dueTick % wheelSize, later rounds share a slot with earlier ones
+        std::vector<Routine> wheel[wheelSize];
+        /// Routines whose waitUntil predicate is checked every tick
+        std::vector<Routine> polling;
+        /// Routines that are due but did not fit in the last tick's budget
+        std::vector<Routine> deferred;
+        /// Routines Update is working through, so Cancel can reach them
+        std::vector<Routine>* resuming = nullptr;
+        /// How many Resume calls are on the stack
+        int resumeDepth = 0;
+        /// Scripts cancelled while a coroutine was running, checked when it yields
+        std::vector<LuaScript*> cancelledOwners;
+
+        void Resume(Routine routine, int argCount, const char* event);
+        void Park(Routine routine, int resultCount);
+        void Schedule(Routine routine, uint64_t dueTick);
+        void Release(Routine& routine);
+        void CancelIn(std::vector<Routine>& routines, LuaScript* owner);
+    };
+}
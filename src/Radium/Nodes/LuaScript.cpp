@@ -1,5 +1,6 @@
 #include <Radium/Nodes/LuaScript.hpp>
 #include <Radium/Nodes/Node.hpp>
+#include <Radium/Nodes/2D/BodyGroup.hpp>
 #include <Radium/Random.hpp>
 #include <Radium/PixelScaleUtil.hpp>
 #include <Radium/AssetLoader.hpp>
@@ -9,6 +10,10 @@
 #include <Flux/Flux.hpp>
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
 
 namespace Radium::Nodes
 {
@@ -536,176 +541,284 @@ namespace Radium::Nodes
         lua_pop(L, 1);
     }
 
-    void push_integer_reference(lua_State *L, int *ptr)
+    // What a key on a wrapped object resolves to, built once per class
+    struct LuaMember
     {
-        auto *ref = static_cast<IntRef *>(lua_newuserdata(L, sizeof(IntRef)));
-        ref->ptr = ptr;
-        luaL_getmetatable(L, "IntRef");
-        lua_setmetatable(L, -2);
-    }
-
-    void push_float_reference(lua_State *L, float *ptr)
+        ClassDB::PropertyKind kind = ClassDB::PropertyKind::Other;
+        size_t offset = 0;
+        // Registered class of the value for object properties, nullptr if it has none
+        ClassDB::ClassInfo *valueClass = nullptr;
+        // Set for methods instead of a property
+        lua_CFunction method = nullptr;
+    };
+
+    // Members are referenced from Lua as light userdata, kept per class and name so their addresses
+    // stay stable. A rebuilt metatable reuses the same entries, which also keeps metatables still
+    // attached to older userdata pointing at valid, updated members
+    static std::unordered_map<ClassDB::ClassInfo *, std::unordered_map<std::string, LuaMember>> luaMembers;
+
+    // Registry key of the table mapping ClassInfo* to its metatable
+    static char classMetatablesKey;
+    // registryVersion the cached metatables were built at
+    static uint32_t classMetatablesVersion = 0;
+
+    static int push_object(lua_State *L, Object *obj, ClassDB::ClassInfo *info);
+
+    static ClassDB::ClassInfo *find_class_by_name(const std::string &name)
     {
-        auto *ref = static_cast<FloatRef *>(lua_newuserdata(L, sizeof(FloatRef)));
-        ref->ptr = ptr;
-        luaL_getmetatable(L, "FloatRef");
-        lua_setmetatable(L, -2);
+        auto it = ClassDB::registeredClasses.find(name);
+        return it != ClassDB::registeredClasses.end() ? &it->second : nullptr;
     }
 
-    void push_bool_reference(lua_State *L, bool *ptr)
+    // Push a member of obj, owner is the stack index of the userdata obj was reached through
+    static int push_member(lua_State *L, Object *obj, int owner, const LuaMember &member)
     {
-        auto *ref = static_cast<BoolRef *>(lua_newuserdata(L, sizeof(BoolRef)));
-        ref->ptr = ptr;
-        luaL_getmetatable(L, "BoolRef");
-        lua_setmetatable(L, -2);
-    }
+        if (member.method)
+        {
+            lua_pushlightuserdata(L, obj); // upvalue 1: 'self'
+            lua_pushvalue(L, owner);       // upvalue 2: keeps a Lua owned 'self' alive
+            lua_pushcclosure(L, member.method, 2);
+            return 1;
+        }
 
-    void push_string_reference(lua_State *L, std::string *ptr)
-    {
-        auto *ref = static_cast<StringRef *>(lua_newuserdata(L, sizeof(StringRef)));
-        ref->ptr = ptr;
-        luaL_getmetatable(L, "StringRef");
-        lua_setmetatable(L, -2);
+        uint8_t *field = reinterpret_cast<uint8_t *>(obj) + member.offset;
+
+        switch (member.kind)
+        {
+        case ClassDB::PropertyKind::Int:
+        case ClassDB::PropertyKind::Enum:
+            lua_pushinteger(L, *reinterpret_cast<int *>(field));
+            return 1;
+        case ClassDB::PropertyKind::UnsignedInt:
+            lua_pushinteger(L, *reinterpret_cast<unsigned int *>(field));
+            return 1;
+        case ClassDB::PropertyKind::Float:
+            lua_pushnumber(L, *reinterpret_cast<float *>(field));
+            return 1;
+        case ClassDB::PropertyKind::Bool:
+            lua_pushboolean(L, *reinterpret_cast<bool *>(field));
+            return 1;
+        case ClassDB::PropertyKind::String:
+        {
+            const std::string &value = *reinterpret_cast<std::string *>(field);
+            lua_pushlstring(L, value.data(), value.size());
+            return 1;
+        }
+        case ClassDB::PropertyKind::Pointer:
+        {
+            void *pointee = *reinterpret_cast<void **>(field);
+            if (member.valueClass && pointee)
+            {
+                // The pointee may be a subclass, so look its class up
+                Object *target = static_cast<Object *>(pointee);
+                return push_object(L, target, ClassDB::FindClass(target));
+            }
+
+            lua_pushlightuserdata(L, pointee);
+            return 1;
+        }
+        default:
+            if (member.valueClass)
+            {
+                // Points into the owner, which may be a value stored in its userdata, so keep it alive
+                push_object(L, reinterpret_cast<Object *>(field), member.valueClass);
+                lua_pushvalue(L, owner);
+                lua_setiuservalue(L, -2, 1);
+                return 1;
+            }
+
+            lua_pushnil(L);
+            return 1;
+        }
     }
 
-    int classdb_lua_newindex(lua_State *L)
+    static int classdb_lua_index(lua_State *L)
     {
-        Object **udata = static_cast<Object **>(lua_touserdata(L, 1));
-        Object *obj = *udata;
-
-        const char *key = luaL_checkstring(L, 2);
-        if (!key || !obj)
-            return luaL_error(L, "Invalid object or key");
+        Object *obj = *static_cast<Object **>(lua_touserdata(L, 1));
 
-        std::string prop_name = key;
-        auto props = ClassDB::GetProperties(obj);
+        lua_pushvalue(L, 2);
+        lua_rawget(L, lua_upvalueindex(1));
+        auto *member = static_cast<const LuaMember *>(lua_touserdata(L, -1));
+        lua_pop(L, 1);
 
-        for (const auto &prop : props)
+        if (obj && member)
         {
-            if (prop.name == prop_name)
-            {
-                const std::string &type = prop.type;
+            return push_member(L, obj, 1, *member);
+        }
 
-                if (type == "int")
-                {
-                    int val = luaL_checkinteger(L, 3);
-                    ClassDB::SetProperty<int>(prop.name, obj, val);
-                    return 0;
-                }
-                else if (type == "float" || type == "double")
-                {
-                    float val = get_float_arg(L, 3);
-                    ClassDB::SetProperty<float>(prop.name, obj, val);
-                    return 0;
-                }
-                else if (type == "bool")
-                {
-                    bool val = lua_toboolean(L, 3);
-                    ClassDB::SetProperty<bool>(prop.name, obj, val);
-                    return 0;
-                }
-                else if (type == "std::string")
-                {
-                    const char *val = luaL_checkstring(L, 3);
-                    ClassDB::SetProperty<std::string>(prop.name, obj, std::string(val));
-                    return 0;
-                }
-            }
+        if (obj && lua_type(L, 2) == LUA_TSTRING && std::strcmp(lua_tostring(L, 2), "__ptr") == 0)
+        {
+            lua_pushlightuserdata(L, obj);
+            return 1;
         }
 
-        return luaL_error(L, "Property '%s' not found on object", key);
+        lua_pushnil(L);
+        return 1;
     }
 
-    int classdb_lua_index(lua_State *L)
+    static int classdb_lua_newindex(lua_State *L)
     {
-        Radium::Nodes::Object **udata = static_cast<Radium::Nodes::Object **>(lua_touserdata(L, 1));
-        Radium::Nodes::Object *obj = *udata;
-
+        Object *obj = *static_cast<Object **>(lua_touserdata(L, 1));
         const char *key = luaL_checkstring(L, 2);
 
-        if (!obj || !key)
+        lua_pushvalue(L, 2);
+        lua_rawget(L, lua_upvalueindex(1));
+        auto *member = static_cast<const LuaMember *>(lua_touserdata(L, -1));
+        lua_pop(L, 1);
+
+        if (!obj || !member || member->method)
         {
-            lua_pushnil(L);
-            return 1;
+            return luaL_error(L, "Property '%s' not found on object", key);
         }
 
-        std::string prop_name = key;
+        uint8_t *field = reinterpret_cast<uint8_t *>(obj) + member->offset;
 
-        // 👇 SPECIAL CASE for __ptr
-        if (prop_name == "__ptr")
+        switch (member->kind)
         {
-            lua_pushlightuserdata(L, obj);
-            return 1;
+        case ClassDB::PropertyKind::Int:
+        case ClassDB::PropertyKind::Enum:
+            *reinterpret_cast<int *>(field) = (int)luaL_checkinteger(L, 3);
+            return 0;
+        case ClassDB::PropertyKind::UnsignedInt:
+            *reinterpret_cast<unsigned int *>(field) = (unsigned int)luaL_checkinteger(L, 3);
+            return 0;
+        case ClassDB::PropertyKind::Float:
+            *reinterpret_cast<float *>(field) = get_float_arg(L, 3);
+            return 0;
+        case ClassDB::PropertyKind::Bool:
+            *reinterpret_cast<bool *>(field) = lua_toboolean(L, 3);
+            return 0;
+        case ClassDB::PropertyKind::String:
+            *reinterpret_cast<std::string *>(field) = get_string_arg(L, 3);
+            return 0;
+        default:
+            return luaL_error(L, "Property '%s' cannot be assigned from Lua", key);
         }
+    }
 
-        // -------- Property lookup ----------
-        auto props = Radium::Nodes::ClassDB::GetProperties(obj);
+    // Build the metatable for a class, its __index and __newindex share one table of members
+    static void build_class_metatable(lua_State *L, ClassDB::ClassInfo *info)
+    {
+        lua_createtable(L, 0, 2);
+        lua_newtable(L);
 
-        for (const auto &prop : props)
+        if (info)
         {
-            if (prop.name == prop_name)
+            auto &members = luaMembers[info];
+
+            // Methods first, derived classes before their parents so overrides win
+            for (ClassDB::ClassInfo *cls = info; cls; cls = cls->parent)
             {
-                const std::string &type = prop.type;
+                std::string prefix = cls->name + "::";
 
-                if (type == "int")
-                {
-                    auto *val = Radium::Nodes::ClassDB::GetPropertyPointer<int>(prop.name, obj);
-                    push_integer_reference(L, val);
-                    return 1;
-                }
-                else if (type == "float" || type == "double")
+                for (const auto &[name, fn] : Lua::luaFuncs)
                 {
-                    auto *val = Radium::Nodes::ClassDB::GetPropertyPointer<float>(prop.name, obj);
-                    push_float_reference(L, val);
-                    return 1;
+                    if (name.compare(0, prefix.size(), prefix) != 0)
+                    {
+                        continue;
+                    }
+
+                    std::string method = name.substr(prefix.size());
+
+                    // Metamethods such as __add go on the metatable itself
+                    if (method.compare(0, 2, "__") == 0)
+                    {
+                        if (method == "__index" || method == "__newindex")
+                        {
+                            continue;
+                        }
+
+                        if (lua_getfield(L, -2, method.c_str()) == LUA_TNIL)
+                        {
+                            lua_pushcfunction(L, fn);
+                            lua_setfield(L, -4, method.c_str());
+                        }
+                        lua_pop(L, 1);
+                        continue;
+                    }
+
+                    if (lua_getfield(L, -1, method.c_str()) != LUA_TNIL)
+                    {
+                        lua_pop(L, 1);
+                        continue;
+                    }
+                    lua_pop(L, 1);
+
+                    LuaMember &member = members[method];
+                    member = LuaMember();
+                    member.method = fn;
+
+                    lua_pushlightuserdata(L, &member);
+                    lua_setfield(L, -2, method.c_str());
                 }
-                else if (type == "bool")
-                {
-                    auto *val = Radium::Nodes::ClassDB::GetPropertyPointer<bool>(prop.name, obj);
-                    push_bool_reference(L, val);
-                    return 1;
-                }
-                else if (type == "std::string")
-                {
-                    auto *val = Radium::Nodes::ClassDB::GetPropertyPointer<std::string>(prop.name, obj);
-                    push_string_reference(L, val);
-                    return 1;
-                }
-                else if (Radium::Nodes::ClassDB::IsEnum(type))
+            }
+
+            // Properties shadow methods of the same name
+            ClassDB::BuildPropertyLookup(info);
+            for (const ClassDB::PropertyInfo &prop : info->allProperties)
+            {
+                LuaMember &member = members[prop.name];
+                member = LuaMember();
+                member.kind = prop.kind;
+                member.offset = prop.offset;
+
+                if (prop.kind == ClassDB::PropertyKind::Pointer)
                 {
-                    auto *val = Radium::Nodes::ClassDB::GetPropertyPointer<int>(prop.name, obj);
-                    push_integer_reference(L, val);
-                    return 1;
+                    member.valueClass = find_class_by_name(prop.type.substr(0, prop.type.find('*')));
                 }
                 else
                 {
-                    auto newObj = Radium::Nodes::ClassDB::GetPropertyAsObject(obj, prop.name);
-                    return classdb_lua_wrap(L, newObj);
+                    member.valueClass = find_class_by_name(prop.type);
                 }
+
+                // allProperties is base first, so derived properties overwrite their parents'
+                lua_pushlightuserdata(L, &member);
+                lua_setfield(L, -2, prop.name.c_str());
             }
         }
 
-        // -------- Method lookup with inheritance ----------
-        ClassDB::ClassInfo classInfoR = ClassDB::GetClassInfo(obj);
-        ClassDB::ClassInfo *classInfo = &classInfoR;
+        lua_pushvalue(L, -1);
+        lua_pushcclosure(L, classdb_lua_index, 1);
+        lua_setfield(L, -3, "__index");
 
-        while (classInfo)
-        {
-            std::string fullFuncName = classInfo->name + "::" + prop_name;
+        lua_pushcclosure(L, classdb_lua_newindex, 1);
+        lua_setfield(L, -2, "__newindex");
+    }
 
-            auto it = Lua::luaFuncs.find(fullFuncName);
-            if (it != Lua::luaFuncs.end())
-            {
-                lua_pushlightuserdata(L, obj); // upvalue 1: 'self'
-                lua_pushcclosure(L, it->second, 1);
-                return 1;
-            }
+    static void push_class_metatable(lua_State *L, ClassDB::ClassInfo *info)
+    {
+        lua_rawgetp(L, LUA_REGISTRYINDEX, &classMetatablesKey);
 
-            classInfo = classInfo->parent;
+        // Registering classes after scripts ran invalidates every cached metatable
+        if (lua_isnil(L, -1) || classMetatablesVersion != ClassDB::registryVersion)
+        {
+            lua_pop(L, 1);
+            lua_newtable(L);
+            lua_pushvalue(L, -1);
+            lua_rawsetp(L, LUA_REGISTRYINDEX, &classMetatablesKey);
+            classMetatablesVersion = ClassDB::registryVersion;
         }
 
-        // Not found
-        lua_pushnil(L);
+        if (lua_rawgetp(L, -1, info) != LUA_TTABLE)
+        {
+            lua_pop(L, 1);
+            build_class_metatable(L, info);
+            lua_pushvalue(L, -1);
+            lua_rawsetp(L, -3, info);
+        }
+
+        lua_remove(L, -2);
+    }
+
+    static int push_object(lua_State *L, Object *obj, ClassDB::ClassInfo *info)
+    {
+        // One user value, holding whatever owns obj when that is another userdata
+        auto **udata = static_cast<Object **>(lua_newuserdatauv(L, sizeof(Object *), 1));
+        *udata = obj;
+
+        push_class_metatable(L, info);
+        lua_setmetatable(L, -2);
+
         return 1;
     }
 
@@ -717,21 +830,36 @@ namespace Radium::Nodes
             return 1;
         }
 
-        // Allocate userdata
-        auto **udata = static_cast<Radium::Nodes::Object **>(
-            lua_newuserdata(L, sizeof(Radium::Nodes::Object *)));
-        *udata = obj;
+        return push_object(L, obj, ClassDB::FindClass(obj));
+    }
 
-        // Set the metatable
-        if (luaL_newmetatable(L, "ClassDBObject"))
+    Object *classdb_lua_to_object(lua_State *L, int index)
+    {
+        if (lua_type(L, index) != LUA_TUSERDATA || !lua_getmetatable(L, index))
         {
-            lua_pushcfunction(L, classdb_lua_index);
-            lua_setfield(L, -2, "__index");
-
-            lua_pushcfunction(L, classdb_lua_newindex);
-            lua_setfield(L, -2, "__newindex");
+            return nullptr;
         }
 
+        lua_getfield(L, -1, "__index");
+        bool wrapped = lua_tocfunction(L, -1) == classdb_lua_index;
+        lua_pop(L, 2);
+
+        return wrapped ? *static_cast<Object **>(lua_touserdata(L, index)) : nullptr;
+    }
+
+    void *classdb_lua_new_value(lua_State *L, size_t size)
+    {
+        // The object pointer comes first like any wrapper, the value follows it in the same block
+        auto *udata = static_cast<uint8_t *>(lua_newuserdatauv(L, classdbValueOffset + size, 0));
+        *reinterpret_cast<Object **>(udata) = nullptr;
+        return udata + classdbValueOffset;
+    }
+
+    int classdb_lua_finish_value(lua_State *L, Object *obj)
+    {
+        *static_cast<Object **>(lua_touserdata(L, -1)) = obj;
+
+        push_class_metatable(L, ClassDB::FindClass(obj));
         lua_setmetatable(L, -2);
 
         return 1;
@@ -830,21 +958,171 @@ namespace Radium::Nodes
         return 1;
     }
 
-    LuaScript::LuaScript(std::string path, SceneTree *tree, bool realLoad)
+    // Every LuaScript shares one interpreter and runs in its own _ENV table
+    static lua_State *sharedState = nullptr;
+    static int sharedStateUsers = 0;
+
+    namespace Lua
     {
-        this->path = path;
-        this->sceneTree = tree;
+        bool persistCompiledChunks = false;
+        LuaScheduler scheduler;
+        LuaProfiler profiler;
+        LuaMemory memory;
+        LuaScript *runningScript = nullptr;
+    }
 
-        if (!realLoad)
+    // Header of a compiled chunk saved next to its script as <path>c
+    struct CompiledChunkHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceHash;
+    };
+
+    static constexpr uint32_t compiledChunkMagic = 0x43554C52; // "RLUC"
+    static constexpr uint32_t compiledChunkVersion = 1;
+
+    // Compiled chunks by path, so a script attached to many nodes is only parsed once
+    static std::unordered_map<std::string, std::string> compiledChunks;
+
+    // Live scripts by path, and the write time each file had when it was last loaded, for hot reload
+    static std::unordered_map<std::string, std::vector<LuaScript *>> scriptsByPath;
+    static std::unordered_map<std::string, std::filesystem::file_time_type> scriptWriteTimes;
+
+    static int chunk_writer(lua_State *L, const void *data, size_t size, void *userData)
+    {
+        static_cast<std::string *>(userData)->append(static_cast<const char *>(data), size);
+        return 0;
+    }
+
+    // FNV-1a, only used to tell whether a saved chunk still matches its source
+    static uint64_t hash_source(const std::string &source)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : source)
         {
-            stubbed = true;
-            return;
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Load a saved chunk if it was compiled from this exact source, pushes the function on success
+    static bool load_saved_chunk(lua_State *L, const std::string &path, uint64_t sourceHash, std::string &bytecode)
+    {
+        std::string chunkPath = path + "c";
+        if (!IsFileUpToDate(chunkPath, path))
+        {
+            return false;
+        }
+
+        MappedFile file;
+        if (!file.Open(chunkPath) || file.Size() <= sizeof(CompiledChunkHeader))
+        {
+            return false;
+        }
+
+        CompiledChunkHeader header;
+        std::memcpy(&header, file.Data(), sizeof(header));
+        if (header.magic != compiledChunkMagic || header.version != compiledChunkVersion || header.sourceHash != sourceHash)
+        {
+            return false;
+        }
+
+        const char *data = reinterpret_cast<const char *>(file.Data()) + sizeof(header);
+        size_t size = file.Size() - sizeof(header);
+
+        // Bytecode from another build of Lua is rejected here, the source is compiled instead
+        if (luaL_loadbufferx(L, data, size, path.c_str(), "b") != LUA_OK)
+        {
+            Flux::Warn("Ignoring compiled Lua chunk {}: {}", chunkPath, lua_tostring(L, -1));
+            lua_pop(L, 1);
+            return false;
+        }
+
+        bytecode.assign(data, size);
+        return true;
+    }
+
+    static void save_chunk(const std::string &path, uint64_t sourceHash, const std::string &bytecode)
+    {
+        CompiledChunkHeader header{compiledChunkMagic, compiledChunkVersion, sourceHash};
+
+        std::string contents(reinterpret_cast<const char *>(&header), sizeof(header));
+        contents += bytecode;
+
+        if (!WriteStringToFile(path + "c", contents))
+        {
+            Flux::Warn("Failed to save compiled Lua chunk for {}", path);
+        }
+    }
+
+    // Push the main function of a script, compiling it only the first time the path is seen
+    static int load_script_chunk(lua_State *L, const std::string &path)
+    {
+        auto cached = compiledChunks.find(path);
+        if (cached != compiledChunks.end())
+        {
+            return luaL_loadbufferx(L, cached->second.data(), cached->second.size(), path.c_str(), "b");
         }
 
-        // Initialize Lua state
-        L = luaL_newstate();
-        luaL_openlibs(L);
+        std::string source = ReadFileToString(path);
+        uint64_t sourceHash = hash_source(source);
+        std::string bytecode;
+
+        if (Lua::persistCompiledChunks && load_saved_chunk(L, path, sourceHash, bytecode))
+        {
+            compiledChunks[path] = std::move(bytecode);
+            return LUA_OK;
+        }
 
+        int result = luaL_loadbufferx(L, source.data(), source.size(), ("@" + path).c_str(), "t");
+        if (result != LUA_OK)
+        {
+            return result;
+        }
+
+        lua_dump(L, chunk_writer, &bytecode, 0);
+
+        if (Lua::persistCompiledChunks)
+        {
+            save_chunk(path, sourceHash, bytecode);
+        }
+
+        compiledChunks[path] = std::move(bytecode);
+        return LUA_OK;
+    }
+
+    static const char *callbackNames[] = {"onLoad", "onTick", "onRender", "onImgui"};
+
+    // Globals new to a script environment, a callback defined after the chunk ran, e.g. in onLoad,
+    // refreshes the script's references to it
+    static int script_env_newindex(lua_State *L)
+    {
+        bool isCallback = false;
+        if (lua_type(L, 2) == LUA_TSTRING)
+        {
+            const char *key = lua_tostring(L, 2);
+            for (const char *name : callbackNames)
+            {
+                isCallback = isCallback || std::strcmp(key, name) == 0;
+            }
+        }
+
+        lua_settop(L, 3);
+        lua_rawset(L, 1);
+
+        lua_pushliteral(L, "script");
+        if (isCallback && lua_rawget(L, 1) == LUA_TLIGHTUSERDATA)
+        {
+            // L may be a coroutine, the shared state's own stack is not ours to use while it runs
+            static_cast<LuaScript *>(lua_touserdata(L, -1))->ResolveCallbacks(L);
+        }
+        return 0;
+    }
+
+    void LuaScript::RegisterGlobals(lua_State *L)
+    {
         // Register logging functions
         lua_register(L, "info", lua_info);
         lua_register(L, "error", lua_error);
@@ -861,17 +1139,18 @@ namespace Radium::Nodes
 
         lua_register(L, "exit", [](lua_State *L) -> int
                      {
-            exit(lua_tointeger(L, 1));
+            int code = (int)lua_tointeger(L, 1);
+            if (Radium::currentApplication) {
+                Radium::currentApplication->Quit(code);
+            } else {
+                exit(code);
+            }
             
             return 0; });
 
         register_reference_metatables(L);
-
-        lua_pushlightuserdata(L, this);
-        lua_setglobal(L, "script");
-
-        classdb_lua_wrap(L, tree);
-        lua_setglobal(L, "tree");
+        LuaScheduler::RegisterGlobals(L);
+        BodyGroup::RegisterGlobals(L);
 
         lua_register(L, "me", lua_get_me);
 
@@ -1254,13 +1533,96 @@ namespace Radium::Nodes
             lua_setglobal(L, constructor.first.c_str());
         }
 
+        // Script environments fall back to the shared globals for anything they do not define
+        luaL_newmetatable(L, "ScriptEnv");
+        lua_pushglobaltable(L);
+        lua_setfield(L, -2, "__index");
+        lua_pushcfunction(L, script_env_newindex);
+        lua_setfield(L, -2, "__newindex");
+        lua_pop(L, 1);
+    }
+
+    // Errors outside of any pcall end up here, right before Lua aborts
+    static int lua_panic(lua_State *L)
+    {
+        const char *message = lua_tostring(L, -1);
+        Flux::Error("Unprotected Lua error: {}", message ? message : "unknown error");
+        return 0;
+    }
+
+    lua_State *LuaScript::AcquireSharedState()
+    {
+        if (!sharedState)
+        {
+            sharedState = lua_newstate(LuaMemory::Alloc, &Lua::memory);
+            lua_atpanic(sharedState, lua_panic);
+            Lua::memory.Attach(sharedState);
+            luaL_openlibs(sharedState);
+            RegisterGlobals(sharedState);
+            Lua::profiler.Attach(sharedState);
+        }
+
+        sharedStateUsers++;
+        return sharedState;
+    }
+
+    void LuaScript::ReleaseSharedState()
+    {
+        if (--sharedStateUsers > 0)
+        {
+            return;
+        }
+
+        lua_close(sharedState);
+        sharedState = nullptr;
+        Lua::memory.Clear();
+        compiledChunks.clear();
+        luaMembers.clear();
+        Lua::scheduler.Clear();
+        Lua::profiler.Clear();
+        classMetatablesVersion = 0;
+    }
+
+    LuaScript::LuaScript(std::string path, SceneTree *tree, bool realLoad)
+    {
+        this->path = path;
+        this->sceneTree = tree;
+
+        if (!realLoad)
+        {
+            stubbed = true;
+            return;
+        }
+
+        L = AcquireSharedState();
+        memoryAccount = Lua::memory.GetAccount(path);
+
+        auto &instances = scriptsByPath[path];
+        if (instances.empty())
+        {
+            scriptWriteTimes[path] = GetFileWriteTime(path);
+        }
+        instances.push_back(this);
+
+        // Globals the script defines land in its own table, reads fall through to the shared one
+        lua_newtable(L);
+        luaL_setmetatable(L, "ScriptEnv");
+        lua_pushvalue(L, -1);
+        lua_setfield(L, -2, "_G");
+
+        lua_pushlightuserdata(L, this);
+        lua_setfield(L, -2, "script");
+
+        classdb_lua_wrap(L, tree);
+        lua_setfield(L, -2, "tree");
+
+        envRef = luaL_ref(L, LUA_REGISTRYINDEX);
+
         // Load and execute the Lua script
         try
         {
-            std::string script = ReadFileToString(path);
-
             // Load the script
-            int result = luaL_loadstring(L, script.c_str());
+            int result = load_script_chunk(L, path);
             if (result != LUA_OK)
             {
                 Flux::Error("Failed to load Lua script: {}", lua_tostring(L, -1));
@@ -1268,8 +1630,17 @@ namespace Radium::Nodes
                 return;
             }
 
+            // The first upvalue of a main chunk is always _ENV
+            lua_rawgeti(L, LUA_REGISTRYINDEX, envRef);
+            lua_setupvalue(L, -2, 1);
+
             // Execute the script
+            LuaScript *previous = Lua::runningScript;
+            Lua::runningScript = this;
+            Lua::profiler.Begin(path);
             result = lua_pcall(L, 0, 0, 0);
+            Lua::profiler.End();
+            Lua::runningScript = previous;
             if (result != LUA_OK)
             {
                 Flux::Error("Failed to execute Lua script: {}", lua_tostring(L, -1));
@@ -1277,6 +1648,8 @@ namespace Radium::Nodes
                 return;
             }
 
+            ResolveCallbacks();
+
             Flux::Info("Lua script loaded successfully: {}", path);
         }
         catch (const std::exception &e)
@@ -1289,103 +1662,363 @@ namespace Radium::Nodes
     {
         if (L)
         {
-            lua_close(L);
+            Lua::scheduler.Cancel(this);
+
+            auto &instances = scriptsByPath[path];
+            instances.erase(std::remove(instances.begin(), instances.end(), this), instances.end());
+            if (instances.empty())
+            {
+                scriptsByPath.erase(path);
+                scriptWriteTimes.erase(path);
+            }
+
+            ReleaseCallbacks();
+
+            // Functions of the script can outlive it, they must not reach it through the environment
+            lua_rawgeti(L, LUA_REGISTRYINDEX, envRef);
+            lua_pushnil(L);
+            lua_setfield(L, -2, "script");
+            lua_pop(L, 1);
+            luaL_unref(L, LUA_REGISTRYINDEX, envRef);
+            ReleaseSharedState();
         }
     }
 
-    void LuaScript::OnLoad()
+    void LuaScript::CheckForChanges()
     {
-        if (stubbed || !L)
+        // Stat calls are not free, a couple of times a second is plenty for editing
+        static auto lastCheck = std::chrono::steady_clock::now();
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastCheck < std::chrono::milliseconds(500))
         {
             return;
         }
+        lastCheck = now;
 
-        // Get the onLoad function from Lua
-        lua_getglobal(L, "onLoad");
-        if (lua_isfunction(L, -1))
+        std::vector<std::string> changed;
+        for (auto &[path, writeTime] : scriptWriteTimes)
         {
-            int result = lua_pcall(L, 0, 0, 0);
-            if (result != LUA_OK)
+            auto current = GetFileWriteTime(path);
+            if (current != writeTime)
             {
-                Flux::Error("Lua OnLoad error: {}", lua_tostring(L, -1));
-                lua_pop(L, 1);
+                writeTime = current;
+                changed.push_back(path);
             }
         }
-        else
+
+        for (const std::string &path : changed)
         {
-            lua_pop(L, 1); // Remove the non-function value
+            ReloadPath(path);
         }
     }
 
-    void LuaScript::OnTick(float dt)
+    void LuaScript::ReloadPath(const std::string &path)
     {
-        if (stubbed || !L)
+        auto it = scriptsByPath.find(path);
+        if (it == scriptsByPath.end() || !sharedState)
         {
             return;
         }
 
-        // Get the onTick function from Lua
-        lua_getglobal(L, "onTick");
-        if (lua_isfunction(L, -1))
+        lua_State *L = sharedState;
+
+        // Compile once, every instance then loads the same bytecode into its own environment
+        std::string source = ReadFileToString(path);
+        if (luaL_loadbufferx(L, source.data(), source.size(), ("@" + path).c_str(), "t") != LUA_OK)
         {
-            int result = lua_pcall(L, 0, 0, 0);
-            if (result != LUA_OK)
+            // Keep running the old version until the file compiles again
+            Flux::Error("Failed to reload Lua script: {}", lua_tostring(L, -1));
+            lua_pop(L, 1);
+            return;
+        }
+
+        std::string bytecode;
+        lua_dump(L, chunk_writer, &bytecode, 0);
+        lua_pop(L, 1);
+
+        if (Lua::persistCompiledChunks)
+        {
+            save_chunk(path, hash_source(source), bytecode);
+        }
+        compiledChunks[path] = bytecode;
+
+        // Reloading may create or destroy scripts, so work on a copy
+        std::vector<LuaScript *> instances = it->second;
+        for (LuaScript *script : instances)
+        {
+            auto current = scriptsByPath.find(path);
+            if (current != scriptsByPath.end() && std::find(current->second.begin(), current->second.end(), script) != current->second.end())
             {
-                Flux::Error("Lua OnTick error: {}", lua_tostring(L, -1));
-                lua_pop(L, 1);
+                script->Reload(bytecode);
             }
         }
-        else
+
+        Flux::Info("Reloaded Lua script {} on {} nodes", path, instances.size());
+    }
+
+    // Whether function was walked already, marking it if not. Local functions can reach each
+    // other, or themselves, through their upvalues
+    static bool mark_visited(lua_State *L, int function, int visited)
+    {
+        lua_pushvalue(L, function);
+        bool seen = lua_rawget(L, visited) != LUA_TNIL;
+        lua_pop(L, 1);
+
+        if (!seen)
         {
-            lua_pop(L, 1); // Remove the non-function value
+            lua_pushvalue(L, function);
+            lua_pushboolean(L, 1);
+            lua_rawset(L, visited);
         }
+        return seen;
     }
 
-    void LuaScript::OnRender()
+    // Record which function holds each data upvalue by name, through local helper functions too
+    static void collect_upvalue_holders(lua_State *L, int function, int holders, int visited, std::unordered_map<std::string, int> &upvalueIndices)
     {
-        if (stubbed || !L)
+        if (mark_visited(L, function, visited))
         {
             return;
         }
 
-        // Get the onRender function from Lua
-        lua_getglobal(L, "onRender");
-        if (lua_isfunction(L, -1))
+        for (int n = 1; const char *name = lua_getupvalue(L, function, n); n++)
         {
-            int result = lua_pcall(L, 0, 0, 0);
-            if (result != LUA_OK)
+            if (lua_isfunction(L, -1))
             {
-                Flux::Error("Lua OnRender error: {}", lua_tostring(L, -1));
+                if (!lua_iscfunction(L, -1))
+                {
+                    collect_upvalue_holders(L, lua_gettop(L), holders, visited, upvalueIndices);
+                }
+            }
+            else if (*name != '\0' && std::strcmp(name, "_ENV") != 0 && !upvalueIndices.count(name))
+            {
+                upvalueIndices[name] = n;
+                lua_pushvalue(L, function);
+                lua_setfield(L, holders, name);
+            }
+            lua_pop(L, 1);
+        }
+    }
+
+    // Point the data upvalues of a fresh function, and of the local helpers it calls, at the old
+    // cells, while the helpers themselves keep their new code
+    static void join_upvalues(lua_State *L, int function, int env, int holders, int visited, const std::unordered_map<std::string, int> &upvalueIndices)
+    {
+        if (mark_visited(L, function, visited))
+        {
+            return;
+        }
+
+        for (int n = 1; const char *name = lua_getupvalue(L, function, n); n++)
+        {
+            if (lua_isfunction(L, -1))
+            {
+                if (!lua_iscfunction(L, -1))
+                {
+                    join_upvalues(L, lua_gettop(L), env, holders, visited, upvalueIndices);
+                }
+                lua_pop(L, 1);
+                continue;
+            }
+            lua_pop(L, 1);
+
+            if (std::strcmp(name, "_ENV") == 0)
+            {
+                lua_pushvalue(L, env);
+                lua_setupvalue(L, function, n);
+                continue;
+            }
+
+            // Share the old local instead of the freshly initialised one
+            auto old = upvalueIndices.find(name);
+            if (old != upvalueIndices.end())
+            {
+                lua_getfield(L, holders, name);
+                lua_upvaluejoin(L, function, n, -1, old->second);
                 lua_pop(L, 1);
             }
         }
-        else
+    }
+
+    void LuaScript::Reload(const std::string &bytecode)
+    {
+        if (luaL_loadbufferx(L, bytecode.data(), bytecode.size(), path.c_str(), "b") != LUA_OK)
+        {
+            Flux::Error("Failed to reload Lua script: {}", lua_tostring(L, -1));
+            lua_pop(L, 1);
+            return;
+        }
+
+        // Run the new version in a scratch table that can still read the current state
+        lua_newtable(L);
+        lua_newtable(L);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, envRef);
+        lua_setfield(L, -2, "__index");
+        lua_setmetatable(L, -2);
+
+        lua_pushvalue(L, -1);
+        lua_setupvalue(L, -3, 1);
+        lua_insert(L, -2);
+
+        LuaScript *previous = Lua::runningScript;
+        Lua::runningScript = this;
+        Lua::profiler.Begin(path);
+        int result = lua_pcall(L, 0, 0, 0);
+        Lua::profiler.End();
+        Lua::runningScript = previous;
+
+        if (result != LUA_OK)
         {
-            lua_pop(L, 1); // Remove the non-function value
+            Flux::Error("Failed to execute reloaded Lua script: {}", lua_tostring(L, -1));
+            lua_pop(L, 2);
+            return;
+        }
+
+        int fresh = lua_gettop(L);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, envRef);
+        int env = lua_gettop(L);
+
+        // Chunk level data locals live in upvalues, remember which old function holds each one by name
+        lua_newtable(L);
+        int holders = lua_gettop(L);
+        lua_newtable(L);
+        int visited = lua_gettop(L);
+        std::unordered_map<std::string, int> upvalueIndices;
+
+        lua_pushnil(L);
+        while (lua_next(L, env))
+        {
+            if (lua_isfunction(L, -1) && !lua_iscfunction(L, -1))
+            {
+                collect_upvalue_holders(L, lua_gettop(L), holders, visited, upvalueIndices);
+            }
+            lua_pop(L, 1);
+        }
+
+        lua_pushnil(L);
+        while (lua_next(L, fresh))
+        {
+            if (lua_isfunction(L, -1))
+            {
+                if (!lua_iscfunction(L, -1))
+                {
+                    join_upvalues(L, lua_gettop(L), env, holders, visited, upvalueIndices);
+                }
+
+                // Functions are always replaced
+                lua_pushvalue(L, -2);
+                lua_pushvalue(L, -2);
+                lua_rawset(L, env);
+            }
+            else
+            {
+                // Data only fills in globals the old version did not have, existing state is kept
+                lua_pushvalue(L, -2);
+                if (lua_rawget(L, env) == LUA_TNIL)
+                {
+                    lua_pushvalue(L, -3);
+                    lua_pushvalue(L, -3);
+                    lua_rawset(L, env);
+                }
+                lua_pop(L, 1);
+            }
+            lua_pop(L, 1);
         }
+
+        lua_pop(L, 4);
+
+        ResolveCallbacks();
     }
 
-    void LuaScript::OnImgui()
+    void LuaScript::ResolveCallbacks(lua_State *thread)
     {
-        if (stubbed || !L)
+        if (!L)
         {
             return;
         }
 
-        // Get the onImgui function from Lua
-        lua_getglobal(L, "onImgui");
-        if (lua_isfunction(L, -1))
+        lua_State *L = thread ? thread : this->L;
+        ReleaseCallbacks(L);
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, envRef);
+        for (int i = 0; i < CallbackCount; i++)
         {
-            int result = lua_pcall(L, 0, 0, 0);
-            if (result != LUA_OK)
+            // rawget, a missing callback must not pick up something from the shared globals
+            lua_pushstring(L, callbackNames[i]);
+            lua_rawget(L, -2);
+
+            if (lua_isfunction(L, -1))
+            {
+                callbackRefs[i] = luaL_ref(L, LUA_REGISTRYINDEX);
+            }
+            else
             {
-                Flux::Error("Lua OnImgui error: {}", lua_tostring(L, -1));
                 lua_pop(L, 1);
             }
         }
-        else
+        lua_pop(L, 1);
+    }
+
+    void LuaScript::ReleaseCallbacks(lua_State *thread)
+    {
+        lua_State *L = thread ? thread : this->L;
+        for (int &ref : callbackRefs)
+        {
+            luaL_unref(L, LUA_REGISTRYINDEX, ref);
+            ref = LUA_NOREF;
+        }
+    }
+
+    void LuaScript::CallCallback(Callback callback, const char *event)
+    {
+        if (stubbed || !L || callbackRefs[callback] == LUA_NOREF)
         {
-            lua_pop(L, 1); // Remove the non-function value
+            return;
         }
+
+        lua_rawgeti(L, LUA_REGISTRYINDEX, callbackRefs[callback]);
+
+        LuaScript *previous = Lua::runningScript;
+        Lua::runningScript = this;
+        Lua::profiler.Begin(path);
+        int result = lua_pcall(L, 0, 0, 0);
+        Lua::profiler.End();
+        Lua::runningScript = previous;
+
+        if (result != LUA_OK)
+        {
+            Flux::Error("Lua {} error: {}", event, lua_tostring(L, -1));
+            lua_pop(L, 1);
+        }
+    }
+
+    void LuaScript::OnLoad()
+    {
+        if (stubbed || !L || callbackRefs[CallbackLoad] == LUA_NOREF)
+        {
+            return;
+        }
+
+        // onLoad runs as a coroutine, so it can wait before finishing its setup
+        lua_rawgeti(L, LUA_REGISTRYINDEX, callbackRefs[CallbackLoad]);
+        Lua::scheduler.Start(L, this, 0, "OnLoad");
+
+        // onLoad may have replaced callbacks the chunk already defined, which __newindex does not see
+        ResolveCallbacks();
+    }
+
+    void LuaScript::OnTick(float dt)
+    {
+        CallCallback(CallbackTick, "OnTick");
+    }
+
+    void LuaScript::OnRender()
+    {
+        CallCallback(CallbackRender, "OnRender");
+    }
+
+    void LuaScript::OnImgui()
+    {
+        CallCallback(CallbackImgui, "OnImgui");
     }
 }
\ No newline at end of file
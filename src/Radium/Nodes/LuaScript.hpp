@@ -1,9 +1,14 @@
 #pragma once
 #include <Radium/Nodes/Script.hpp>
 #include <Radium/Nodes/Tree.hpp>
+#include <Radium/Nodes/LuaScheduler.hpp>
+#include <Radium/Nodes/LuaProfiler.hpp>
+#include <Radium/Nodes/LuaMemory.hpp>
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <new>
+#include <type_traits>
 
 extern "C" {
 #include <lua.h>
@@ -76,6 +81,70 @@ namespace Radium::Nodes {
      */
     int classdb_lua_wrap(lua_State *L, Radium::Nodes::Object *obj);
 
+    /**
+     * @brief Get the object behind a wrapped ClassDB value
+     * 
+     * @param L Lua state.
+     * @param index Stack index of the value
+     * 
+     * @return Object* The wrapped object, or nullptr if the value is not a ClassDB object
+     */
+    Object* classdb_lua_to_object(lua_State *L, int index);
+
+    /**
+     * @brief Get a wrapped ClassDB value as a specific class
+     * 
+     * @tparam T Class to cast to
+     * @param L Lua state.
+     * @param index Stack index of the value
+     * 
+     * @return T* The wrapped object, or nullptr if the value is not a T
+     */
+    template <typename T>
+    T* classdb_lua_to(lua_State *L, int index)
+    {
+        return dynamic_cast<T*>(classdb_lua_to_object(L, index));
+    }
+
+    /// Where a value pushed with classdb_lua_push_value starts inside its userdata
+    constexpr size_t classdbValueOffset = sizeof(Object*);
+
+    /**
+     * @brief Push a userdata with room for a value, used by classdb_lua_push_value
+     * 
+     * @return void* Storage to construct the value in
+     */
+    void* classdb_lua_new_value(lua_State *L, size_t size);
+
+    /**
+     * @brief Point the userdata on top of the stack at the value constructed in it and set its metatable
+     */
+    int classdb_lua_finish_value(lua_State *L, Object *obj);
+
+    /**
+     * @brief Push a copy of a value type such as Vector2f to Lua
+     * 
+     * classdb_lua_wrap only borrows an object, whoever created it still owns it. A value pushed
+     * here is copied into the userdata itself and freed along with it by Lua's GC, so temporary
+     * vectors in scripts never touch the C++ heap. Its destructor is not run, so T must not own
+     * any resources.
+     * 
+     * @tparam T Class of the value
+     * @param L Lua state.
+     * @param value Value to copy
+     * 
+     * @return int Number of results pushed to the Lua stack
+     */
+    template <typename T>
+    int classdb_lua_push_value(lua_State *L, const T &value)
+    {
+        static_assert(std::is_base_of_v<Object, T>, "Values must be ClassDB objects");
+        static_assert(alignof(T) <= classdbValueOffset, "Value is over-aligned for a userdata");
+
+        T* object = new (classdb_lua_new_value(L, sizeof(T))) T(value);
+        return classdb_lua_finish_value(L, object);
+    }
+
     namespace Lua {
         /**
          * @brief Container for all registered functions
@@ -89,12 +158,36 @@ namespace Radium::Nodes {
          * Holds the constructors for all classes to be later exposed to Lua
          */
         extern std::unordered_map<std::string, lua_CFunction> luaConstructors;
+        /**
+         * @brief Whether compiled scripts are saved next to their source
+         * 
+         * Each script is written as <path>c along with a hash of its source, and reused on the next
+         * run while the source is unchanged. Off by default since the asset folder may be read-only.
+         */
+        extern bool persistCompiledChunks;
+        /**
+         * @brief Coroutine scheduler shared by all scripts, advanced once per tick by the Application
+         */
+        extern LuaScheduler scheduler;
+        /**
+         * @brief Profiler charging script time to scripts and functions, closed once per frame by the Application
+         */
+        extern LuaProfiler profiler;
+        /**
+         * @brief Allocator of the shared state, charging memory to the script that allocated it
+         */
+        extern LuaMemory memory;
+        /**
+         * @brief Script whose code is currently running, coroutines it spawns belong to it
+         */
+        extern LuaScript* runningScript;
     }
 
     /**
      * @brief Wraps Lua scripts so they can be used on nodes
      * 
-     * Loads, manages and executes Lua scripts on a node.
+     * Loads, manages and executes Lua scripts on a node. All scripts share one interpreter,
+     * each one runs in its own environment table so their globals stay separate.
      */
     class LuaScript: public Script {
     public:
@@ -141,6 +234,10 @@ namespace Radium::Nodes {
          * Path to the script
          */
         std::string path;
+        /**
+         * Account in Lua::memory that allocations made by the script are charged to
+         */
+        uint32_t memoryAccount = 0;
         /**
          * @brief Get the node the script is attached to
          * 
@@ -159,11 +256,78 @@ namespace Radium::Nodes {
          * Helper function to change the node the script is attached to
          */
         void SetMe(Node node);
+        /**
+         * @brief Look up the script's onLoad, onTick, onRender and onImgui functions
+         * 
+         * Done once after the script runs, callbacks are called through the stored references
+         * afterwards. Call again after re-running the script, e.g. when reloading it. Also called
+         * when the script defines a new callback global later on, like from onLoad.
+         * 
+         * @param thread Lua thread to use the stack of, the shared state when null
+         */
+        void ResolveCallbacks(lua_State* thread = nullptr);
+
+        /**
+         * @brief Reload the scripts whose files changed on disk since they were loaded
+         * 
+         * Checks at most twice a second. Called every tick when Application::hotReloadScripts is set.
+         */
+        static void CheckForChanges();
+        /**
+         * @brief Recompile a script and swap the new code into every instance using it
+         * 
+         * Functions are replaced, while the values the script stored in its globals and in chunk
+         * level locals of the same name are kept, so nodes carry on from where they were. The
+         * node itself is not touched. If the file fails to compile the old code keeps running.
+         * 
+         * @param path Path of the script, as passed to the constructor
+         */
+        static void ReloadPath(const std::string& path);
 
     private:
         SceneTree* sceneTree;
         bool stubbed = false;
-        lua_State* L;
+        /// The shared interpreter, null while stubbed
+        lua_State* L = nullptr;
+        /// Registry reference to this script's _ENV table
+        int envRef = LUA_NOREF;
+
+        /**
+         * @brief Get the interpreter shared by all scripts, creating it for the first one
+         */
+        static lua_State* AcquireSharedState();
+        /**
+         * @brief Release the shared interpreter, closing it once the last script is gone
+         */
+        static void ReleaseSharedState();
+        /**
+         * @brief Register the engine API into the shared globals table
+         */
+        static void RegisterGlobals(lua_State* L);
+
+        enum Callback {
+            CallbackLoad,
+            CallbackTick,
+            CallbackRender,
+            CallbackImgui,
+            CallbackCount
+        };
+
+        /// Registry references to the script's callbacks, LUA_NOREF for ones it does not define
+        int callbackRefs[CallbackCount] = {LUA_NOREF, LUA_NOREF, LUA_NOREF, LUA_NOREF};
+
+        /**
+         * @brief Drop the callback references
+         */
+        void ReleaseCallbacks(lua_State* thread = nullptr);
+        /**
+         * @brief Run new bytecode for this script against its existing environment
+         */
+        void Reload(const std::string& bytecode);
+        /**
+         * @brief Call one of the script's callbacks, does nothing if the script does not define it
+         */
+        void CallCallback(Callback callback, const char* event);
         
         // Lua function wrappers
         static int lua_info(lua_State* L);
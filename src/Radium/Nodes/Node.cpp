@@ -4,7 +4,7 @@
 
 namespace Radium::Nodes {
     Node::Node() : parent(nullptr) {
-        name = std::string(Demangle(typeid(this).name()));
+        name = GetTypeName(typeid(this));
     }
 
     void Node::Register() {
@@ -59,6 +59,16 @@ namespace Radium::Nodes {
         }
     }
 
+    bool Node::IsTickThreadSafe() {
+        return script == nullptr;
+    }
+
+    void Node::UpdateTransforms() {
+        for (auto& child : children) {
+            child->UpdateTransforms();
+        }
+    }
+
     Node* Node::GetChildByName(std::string name) {
         for (auto& child : children) {
             if (child) {
@@ -71,6 +71,20 @@ namespace Radium::Nodes {
          */
         virtual void OnImgui();
 
+        /**
+         * @brief Whether this node's own OnTick may run on a worker thread
+         * 
+         * A subtree where every node returns true can be ticked in parallel with other
+         * such subtrees. Nodes with a script, or that talk to shared engine state such as
+         * the physics world, must return false.
+         */
+        virtual bool IsTickThreadSafe();
+
+        /**
+         * @brief Bring the global transforms of this node and its children up to date without ticking
+         */
+        virtual void UpdateTransforms();
+
         /**
          * @brief Get a child node by its name
          */
@@ -0,0 +1,537 @@
+#include <Radium/Nodes/SceneBinary.hpp>
+#include <Radium/Nodes/Tree.hpp>
+#include <Radium/Nodes/LuaScript.hpp>
+#include <Radium/AssetLoader.hpp>
+#include <Radium/Math.hpp>
+#include <Flux/Flux.hpp>
+#include <tracy/Tracy.hpp>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+
+namespace Radium::Nodes
+{
+    using namespace SceneBinary;
+
+    static uint32_t AlignTo4(uint32_t value)
+    {
+        return (value + 3u) & ~3u;
+    }
+
+    // Whether count records of at least recordSize bytes each can start at offset
+    static bool FitsTable(size_t size, uint32_t offset, uint32_t count, size_t recordSize)
+    {
+        return offset <= size && (uint64_t)count * recordSize <= size - offset;
+    }
+
+    // Payload size of a property value, 0 for kinds that are never written
+    static uint32_t PayloadSize(ClassDB::PropertyKind kind)
+    {
+        switch (kind)
+        {
+        case ClassDB::PropertyKind::Int:
+        case ClassDB::PropertyKind::UnsignedInt:
+        case ClassDB::PropertyKind::Float:
+        case ClassDB::PropertyKind::Bool:
+        case ClassDB::PropertyKind::Enum:
+        case ClassDB::PropertyKind::String:
+            return 4;
+        case ClassDB::PropertyKind::Vector2f:
+            return 8;
+        case ClassDB::PropertyKind::RectangleF:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    // Appends little endian values to a growing buffer
+    class BinaryWriter
+    {
+    public:
+        std::vector<uint8_t> bytes;
+
+        void Write(const void *data, size_t size)
+        {
+            const uint8_t *begin = static_cast<const uint8_t *>(data);
+            bytes.insert(bytes.end(), begin, begin + size);
+        }
+
+        template <typename T>
+        void Write(const T &value)
+        {
+            Write(&value, sizeof(T));
+        }
+
+        void Align()
+        {
+            bytes.resize(AlignTo4((uint32_t)bytes.size()), 0);
+        }
+
+        uint32_t Size() const
+        {
+            return (uint32_t)bytes.size();
+        }
+    };
+
+    // Bounds checked cursor over a mapped file
+    class BinaryReader
+    {
+    public:
+        BinaryReader(const uint8_t *data, size_t size, size_t position) : data(data), size(size), position(position) {}
+
+        template <typename T>
+        bool Read(T &value)
+        {
+            if (position > size || size - position < sizeof(T))
+                return false;
+
+            std::memcpy(&value, data + position, sizeof(T));
+            position += sizeof(T);
+            return true;
+        }
+
+        bool Skip(size_t count)
+        {
+            if (position > size || size - position < count)
+                return false;
+
+            position += count;
+            return true;
+        }
+
+        const uint8_t *Current() const
+        {
+            return data + position;
+        }
+
+    private:
+        const uint8_t *data;
+        size_t size;
+        size_t position;
+    };
+
+    void SceneTree::SerializeBinary(std::string path)
+    {
+        ZoneScopedN("Serialize Binary Scene");
+
+        std::vector<std::string> strings;
+        std::unordered_map<std::string, uint32_t> stringIndices;
+        auto intern = [&](const std::string &value) -> uint32_t
+        {
+            auto it = stringIndices.find(value);
+            if (it != stringIndices.end())
+                return it->second;
+
+            uint32_t index = (uint32_t)strings.size();
+            strings.push_back(value);
+            stringIndices.emplace(value, index);
+            return index;
+        };
+
+        std::vector<uint32_t> types;
+        std::unordered_map<ClassDB::ClassInfo *, uint32_t> typeIndices;
+        std::vector<PropertyRecord> properties;
+        std::unordered_map<uint64_t, uint32_t> propertyIndices;
+
+        BinaryWriter nodeData;
+        uint32_t nodeCount = 0;
+
+        std::function<void(Node *, uint32_t)> writeNode = [&](Node *node, uint32_t parentIndex)
+        {
+            ClassDB::ClassInfo *info = ClassDB::FindClass(node);
+            if (!info)
+            {
+                Flux::Warn("Skipping unregistered node type {} in binary scene", ClassDB::GetType(node));
+                return;
+            }
+
+            auto typeIt = typeIndices.find(info);
+            if (typeIt == typeIndices.end())
+            {
+                typeIt = typeIndices.emplace(info, (uint32_t)types.size()).first;
+                types.push_back(intern(info->name));
+            }
+
+            NodeRecord record;
+            record.type = typeIt->second;
+            record.parent = parentIndex;
+            record.script = none;
+            record.valueCount = 0;
+
+            if (auto luaScript = dynamic_cast<LuaScript *>(node->script))
+            {
+                record.script = intern(luaScript->path);
+            }
+
+            BinaryWriter values;
+            for (const auto &prop : ClassDB::GetProperties(node))
+            {
+                if (prop.name == "parent" || PayloadSize(prop.kind) == 0)
+                    continue;
+
+                uint32_t nameString = intern(prop.name);
+                uint64_t key = ((uint64_t)record.type << 32) | nameString;
+                auto propIt = propertyIndices.find(key);
+                if (propIt == propertyIndices.end())
+                {
+                    propIt = propertyIndices.emplace(key, (uint32_t)properties.size()).first;
+                    properties.push_back({record.type, nameString, (uint32_t)prop.kind});
+                }
+
+                values.Write(propIt->second);
+
+                const uint8_t *field = reinterpret_cast<const uint8_t *>(node) + prop.offset;
+                switch (prop.kind)
+                {
+                case ClassDB::PropertyKind::Bool:
+                    values.Write<uint32_t>(*reinterpret_cast<const bool *>(field) ? 1 : 0);
+                    break;
+                case ClassDB::PropertyKind::String:
+                    values.Write(intern(*reinterpret_cast<const std::string *>(field)));
+                    break;
+                case ClassDB::PropertyKind::Vector2f:
+                {
+                    auto v = reinterpret_cast<const Radium::Vector2f *>(field);
+                    values.Write(v->x);
+                    values.Write(v->y);
+                    break;
+                }
+                case ClassDB::PropertyKind::RectangleF:
+                {
+                    auto r = reinterpret_cast<const Radium::RectangleF *>(field);
+                    values.Write(r->x);
+                    values.Write(r->y);
+                    values.Write(r->w);
+                    values.Write(r->h);
+                    break;
+                }
+                default:
+                    // Int, UnsignedInt, Float and Enum are all 4 bytes wide
+                    values.Write(field, 4);
+                    break;
+                }
+
+                record.valueCount++;
+            }
+
+            uint32_t index = nodeCount++;
+            nodeData.Write(record);
+            nodeData.Write(values.bytes.data(), values.bytes.size());
+
+            for (Node *child : node->children)
+            {
+                writeNode(child, index);
+            }
+        };
+
+        for (Node *node : nodes)
+        {
+            writeNode(node, none);
+        }
+
+        Header header = {};
+        header.magic = magic;
+        header.version = version;
+        header.nameString = intern(name);
+
+        BinaryWriter file;
+        file.Write(header);
+
+        header.stringsOffset = file.Size();
+        header.stringCount = (uint32_t)strings.size();
+        for (const auto &value : strings)
+        {
+            file.Write((uint32_t)value.size());
+            file.Write(value.data(), value.size());
+            file.Write<char>('\0');
+            file.Align();
+        }
+
+        header.typesOffset = file.Size();
+        header.typeCount = (uint32_t)types.size();
+        file.Write(types.data(), types.size() * sizeof(uint32_t));
+
+        header.propertiesOffset = file.Size();
+        header.propertyCount = (uint32_t)properties.size();
+        file.Write(properties.data(), properties.size() * sizeof(PropertyRecord));
+
+        header.nodesOffset = file.Size();
+        header.nodeCount = nodeCount;
+        file.Write(nodeData.bytes.data(), nodeData.bytes.size());
+
+        header.fileSize = file.Size();
+        std::memcpy(file.bytes.data(), &header, sizeof(header));
+
+        std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+        {
+            Flux::Error("Failed to write binary scene: {}", path);
+            return;
+        }
+
+        out.write(reinterpret_cast<const char *>(file.bytes.data()), file.bytes.size());
+        Flux::Info("Wrote binary scene '{}' ({} nodes, {} bytes)", path, nodeCount, file.bytes.size());
+    }
+
+    bool SceneTree::DeserializeBinary(std::string path, bool stubScripts, bool external)
+    {
+        ZoneScopedN("Deserialize Binary Scene");
+
+        MappedFile file;
+        if (!file.Open(path, external))
+        {
+            return false;
+        }
+
+        const uint8_t *data = file.Data();
+        size_t size = file.Size();
+
+        Header header;
+        if (size < sizeof(Header))
+        {
+            Flux::Error("Binary scene {} is truncated", path);
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(Header));
+
+        if (header.magic != magic || header.version != version || header.fileSize != size)
+        {
+            Flux::Error("Binary scene {} has a bad header or was written by a different version", path);
+            return false;
+        }
+
+        // Every table is checked against the file before anything is sized from its count,
+        // a string is at least its length and a terminator padded to 4 bytes
+        if (!FitsTable(size, header.stringsOffset, header.stringCount, sizeof(uint32_t) + 4) ||
+            !FitsTable(size, header.typesOffset, header.typeCount, sizeof(uint32_t)) ||
+            !FitsTable(size, header.propertiesOffset, header.propertyCount, sizeof(PropertyRecord)) ||
+            !FitsTable(size, header.nodesOffset, header.nodeCount, sizeof(NodeRecord)))
+        {
+            Flux::Error("Binary scene {} is truncated", path);
+            return false;
+        }
+
+        // Strings point straight into the mapping, they are only copied where a node keeps them
+        std::vector<std::string_view> strings(header.stringCount);
+        {
+            BinaryReader reader(data, size, header.stringsOffset);
+            for (auto &value : strings)
+            {
+                uint32_t length;
+                const char *chars = nullptr;
+                if (reader.Read(length))
+                {
+                    chars = reinterpret_cast<const char *>(reader.Current());
+                }
+
+                if (!chars || !reader.Skip(AlignTo4(length + 1)))
+                {
+                    Flux::Error("Binary scene {} is truncated", path);
+                    return false;
+                }
+
+                value = std::string_view(chars, length);
+            }
+        }
+
+        auto stringAt = [&](uint32_t index) -> std::string_view
+        {
+            return index < strings.size() ? strings[index] : std::string_view();
+        };
+
+        // Resolve every class and property once, node records then only index into these
+        std::vector<ClassDB::ClassInfo *> classes(header.typeCount, nullptr);
+        {
+            BinaryReader reader(data, size, header.typesOffset);
+            for (auto &info : classes)
+            {
+                uint32_t nameString;
+                if (!reader.Read(nameString))
+                {
+                    Flux::Error("Binary scene {} is truncated", path);
+                    return false;
+                }
+
+                auto it = ClassDB::registeredClasses.find(std::string(stringAt(nameString)));
+                if (it == ClassDB::registeredClasses.end())
+                {
+                    Flux::Error("Class not registered: {}", stringAt(nameString));
+                    continue;
+                }
+                info = &it->second;
+            }
+        }
+
+        std::vector<PropertyRecord> records(header.propertyCount);
+        std::vector<ClassDB::PropertyId> properties(header.propertyCount);
+        {
+            BinaryReader reader(data, size, header.propertiesOffset);
+            for (uint32_t i = 0; i < header.propertyCount; i++)
+            {
+                if (!reader.Read(records[i]))
+                {
+                    Flux::Error("Binary scene {} is truncated", path);
+                    return false;
+                }
+
+                if (records[i].type >= classes.size() || !classes[records[i].type])
+                    continue;
+
+                ClassDB::PropertyId id = ClassDB::ResolveProperty(classes[records[i].type], std::string(stringAt(records[i].name)));
+                if (id && (uint32_t)id.kind == records[i].kind)
+                {
+                    properties[i] = id;
+                }
+                else
+                {
+                    Flux::Warn("Ignoring property {} in binary scene, it no longer matches the class", stringAt(records[i].name));
+                }
+            }
+        }
+
+        std::vector<Node *> created(header.nodeCount, nullptr);
+        std::vector<Node *> roots;
+        // Scripts run as soon as they are created, so they wait until the whole file is known to be good
+        std::vector<std::pair<Node *, uint32_t>> scripts;
+        BinaryReader reader(data, size, header.nodesOffset);
+        bool ok = true;
+
+        for (uint32_t i = 0; i < header.nodeCount && ok; i++)
+        {
+            NodeRecord record;
+            if (!reader.Read(record))
+            {
+                ok = false;
+                break;
+            }
+
+            Node *parentNode = nullptr;
+            bool parentMissing = false;
+            if (record.parent != none)
+            {
+                parentNode = record.parent < i ? created[record.parent] : nullptr;
+                parentMissing = parentNode == nullptr;
+            }
+
+            Node *node = nullptr;
+            ClassDB::ClassInfo *info = record.type < classes.size() ? classes[record.type] : nullptr;
+            if (info && info->factory && !parentMissing)
+            {
+                node = dynamic_cast<Node *>(info->factory());
+            }
+
+            if (node && record.script != none)
+            {
+                scripts.emplace_back(node, record.script);
+            }
+
+            for (uint32_t v = 0; v < record.valueCount; v++)
+            {
+                uint32_t propertyIndex;
+                if (!reader.Read(propertyIndex) || propertyIndex >= records.size())
+                {
+                    ok = false;
+                    break;
+                }
+
+                ClassDB::PropertyKind kind = (ClassDB::PropertyKind)records[propertyIndex].kind;
+                const uint8_t *payload = reader.Current();
+                if (!reader.Skip(PayloadSize(kind)))
+                {
+                    ok = false;
+                    break;
+                }
+
+                const ClassDB::PropertyId &id = properties[propertyIndex];
+                if (!node || !id)
+                    continue;
+
+                uint8_t *field = reinterpret_cast<uint8_t *>(node) + id.offset;
+                switch (kind)
+                {
+                case ClassDB::PropertyKind::Bool:
+                {
+                    uint32_t value;
+                    std::memcpy(&value, payload, 4);
+                    *reinterpret_cast<bool *>(field) = value != 0;
+                    break;
+                }
+                case ClassDB::PropertyKind::String:
+                {
+                    uint32_t index;
+                    std::memcpy(&index, payload, 4);
+                    *reinterpret_cast<std::string *>(field) = std::string(stringAt(index));
+                    break;
+                }
+                case ClassDB::PropertyKind::Vector2f:
+                {
+                    auto target = reinterpret_cast<Radium::Vector2f *>(field);
+                    std::memcpy(&target->x, payload, 4);
+                    std::memcpy(&target->y, payload + 4, 4);
+                    break;
+                }
+                case ClassDB::PropertyKind::RectangleF:
+                {
+                    auto target = reinterpret_cast<Radium::RectangleF *>(field);
+                    std::memcpy(&target->x, payload, 4);
+                    std::memcpy(&target->y, payload + 4, 4);
+                    std::memcpy(&target->w, payload + 8, 4);
+                    std::memcpy(&target->h, payload + 12, 4);
+                    break;
+                }
+                default:
+                    std::memcpy(field, payload, 4);
+                    break;
+                }
+            }
+
+            if (!ok)
+            {
+                // Not in created yet, so the cleanup below would miss it
+                delete node;
+                break;
+            }
+
+            if (!node)
+                continue;
+
+            created[i] = node;
+            node->parent = parentNode;
+            if (parentNode)
+            {
+                parentNode->children.push_back(node);
+            }
+            else
+            {
+                roots.push_back(node);
+            }
+        }
+
+        if (!ok)
+        {
+            Flux::Error("Binary scene {} is truncated", path);
+            for (Node *node : created)
+            {
+                delete node;
+            }
+            return false;
+        }
+
+        for (auto &[node, script] : scripts)
+        {
+            auto luaScript = new LuaScript(std::string(stringAt(script)), this, !stubScripts);
+            luaScript->me = node;
+            node->script = luaScript;
+        }
+
+        name = std::string(stringAt(header.nameString));
+        nodes = std::move(roots);
+        tickGroupsDirty = true;
+        spriteGridDirty = true;
+
+        Flux::Info("Loaded binary scene '{}' ({} nodes)", path, header.nodeCount);
+        return true;
+    }
+}
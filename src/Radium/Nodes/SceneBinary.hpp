@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Radium::Nodes::SceneBinary {
+    /*
+     * Layout of a binary scene (.rscnb), all values little endian and 4 byte aligned:
+     *
+     *   Header
+     *   Strings     stringCount x { uint32 length, chars, '\0', padding }
+     *   Types       typeCount x uint32 string index of the class name
+     *   Properties  propertyCount x PropertyRecord
+     *   Nodes       nodeCount x { NodeRecord, valueCount x { uint32 property, payload } }
+     *
+     * Nodes are stored depth first, so a node's parent always comes before it. Payloads are
+     * 4 bytes for Int, UnsignedInt, Float, Bool, Enum and String (a string index), 8 bytes for
+     * Vector2f and 16 bytes for RectangleF.
+     */
+
+    /// "RSCB"
+    constexpr uint32_t magic = 0x42435352;
+    constexpr uint32_t version = 1;
+    /// Marks a missing string or parent index
+    constexpr uint32_t none = 0xFFFFFFFF;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t nameString;
+        uint32_t stringCount;
+        uint32_t typeCount;
+        uint32_t propertyCount;
+        uint32_t nodeCount;
+        uint32_t stringsOffset;
+        uint32_t typesOffset;
+        uint32_t propertiesOffset;
+        uint32_t nodesOffset;
+        uint32_t fileSize;
+    };
+
+    struct PropertyRecord {
+        /// Index into the type table of the class the property was resolved on
+        uint32_t type;
+        /// String index of the property name
+        uint32_t name;
+        /// ClassDB::PropertyKind the payload was written as
+        uint32_t kind;
+    };
+
+    struct NodeRecord {
+        /// Index into the type table
+        uint32_t type;
+        /// Index of the parent node, none for roots
+        uint32_t parent;
+        /// String index of the LuaScript path, none if the node has no script
+        uint32_t script;
+        /// Number of property values following this record
+        uint32_t valueCount;
+    };
+}
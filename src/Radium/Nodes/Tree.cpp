@@ -1,8 +1,13 @@
 #include <Radium/Nodes/Tree.hpp>
 #include <Radium/Nodes/LuaScript.hpp>
 #include <Radium/Nodes/2D/Node2D.hpp>
+#include <Radium/Nodes/2D/Sprite2D.hpp>
+#include <Radium/PixelScaleUtil.hpp>
+#include <Radium/Camera.hpp>
 #include <Radium/Math.hpp>
 #include <Radium/AssetLoader.hpp>
+#include <Radium/Application.hpp>
+#include <Radium/JobSystem.hpp>
 #include <fstream>
 #include <ostream>
 #include <Flux/Flux.hpp>
@@ -34,22 +39,130 @@ namespace Radium::Nodes
         {
             node->OnLoad();
         }
+
+        tickGroupsDirty = true;
+        spriteGridDirty = true;
     }
 
     void SceneTree::OnTick(float dt)
     {
-        for (auto &node : nodes)
+        JobSystem *jobs = Radium::currentApplication ? Radium::currentApplication->GetJobSystem() : nullptr;
+
+        if (!parallelTick || !jobs || jobs->GetThreadCount() <= 1)
+        {
+            for (auto &node : nodes)
+            {
+                node->OnTick(dt);
+            }
+            return;
+        }
+
+        if (tickGroupsDirty || tickGroupRoots != nodes)
+        {
+            RebuildTickGroups();
+        }
+
+        // Independent subtrees first, so nothing on this thread races with them
+        jobs->ParallelFor(parallelRoots.size(), 1, [this, dt](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                parallelRoots[i]->OnTick(dt);
+            }
+        });
+
+        for (auto &node : serialRoots)
         {
             node->OnTick(dt);
         }
     }
 
+    void SceneTree::RebuildSpriteGrid()
+    {
+        spriteGrid.Build(nodes);
+        spriteGridRoots = nodes;
+        spriteGridDirty = false;
+
+        Flux::Trace("Scene {}: sprite grid holds {} sprites", name, spriteGrid.GetCount());
+    }
+
+    static bool IsSubtreeTickThreadSafe(Node *node)
+    {
+        if (!node->IsTickThreadSafe())
+        {
+            return false;
+        }
+
+        for (auto *child : node->children)
+        {
+            if (!IsSubtreeTickThreadSafe(child))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void SceneTree::RebuildTickGroups()
+    {
+        parallelRoots.clear();
+        serialRoots.clear();
+
+        for (auto *node : nodes)
+        {
+            if (IsSubtreeTickThreadSafe(node))
+            {
+                parallelRoots.push_back(node);
+            }
+            else
+            {
+                serialRoots.push_back(node);
+            }
+        }
+
+        tickGroupRoots = nodes;
+        tickGroupsDirty = false;
+
+        Flux::Trace("Scene {}: {} parallel and {} serial root subtrees", name, parallelRoots.size(), serialRoots.size());
+    }
+
     void SceneTree::OnRender()
     {
+        if (cullSprites && (spriteGridDirty || spriteGridRoots != nodes))
+        {
+            RebuildSpriteGrid();
+        }
+
+        // Nested trees, like a SubViewport's, set their own grid while they render
+        const SpriteGrid *previous = Sprite2D::culledBy;
+        Sprite2D::culledBy = cullSprites ? &spriteGrid : nullptr;
+
         for (auto &node : nodes)
         {
             node->OnRender();
         }
+
+        Sprite2D::culledBy = previous;
+
+        if (!cullSprites)
+        {
+            return;
+        }
+
+        spriteGrid.Update();
+
+        float width = Rune::currentViewport ? (float)Rune::currentViewport->width : (float)Rune::windowWidth;
+        float height = Rune::currentViewport ? (float)Rune::currentViewport->height : (float)Rune::windowHeight;
+        Radium::Camera fallbackCamera;
+        Radium::Camera *camera = Radium::currentApplication ? Radium::currentApplication->GetCamera() : &fallbackCamera;
+        Radium::RectangleF area = camera->GetVisibleArea(width, height, Radium::GetPixelScale());
+
+        spriteGrid.Query(area, visibleSprites);
+        for (auto *sprite : visibleSprites)
+        {
+            sprite->Draw();
+        }
     }
 
     void SceneTree::OnImgui()
@@ -63,8 +176,7 @@ namespace Radium::Nodes
     json SerializeNode(Node *node)
     {
         json nodeJson;
-        std::string typeName = Demangle(typeid(*node).name());
-        nodeJson["type"] = typeName;
+        nodeJson["type"] = ClassDB::GetType(node);
 
         // Serialize script if it's a ChaiScript
         if (ClassDB::HasProperty("script", node))
@@ -87,53 +199,41 @@ namespace Radium::Nodes
             if (prop.name == "parent")
                 continue; // avoid circular references
 
-            if (ClassDB::IsEnum(prop.type)) {
-                nodeJson[prop.name] = ClassDB::GetProperty<int>(prop.name, node);
-            }
+            ClassDB::PropertyId id = ClassDB::ResolveProperty(prop);
 
-            if (prop.type == "int")
-            {
-                nodeJson[prop.name] = ClassDB::GetProperty<int>(prop.name, node);
-            }
-            else if (prop.type == "float")
-            {
-                nodeJson[prop.name] = ClassDB::GetProperty<float>(prop.name, node);
-            }
-            else if (prop.type == "unsigned int")
-            {
-                nodeJson[prop.name] = ClassDB::GetProperty<unsigned int>(prop.name, node);
-            }
-            #if !defined(_MSC_VER)
-            #if defined(__EMSCRIPTEN__)
-            else if (prop.type == "std::__2::basic_string<char, std::__2::char_traits<char>, std::__2::allocator<char>>")
-            #else
-            #if defined(__ANDROID__)
-            else if (prop.type == "std::__ndk1::basic_string<char, std::__ndk1::char_traits<char>, std::__ndk1::allocator<char>>")
-            #else
-            else if (prop.type == "std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> >")
-            #endif
-            #endif
-            #else
-            else if (prop.type == "std::basic_string<char,struct std::char_traits<char>,class std::allocator<char> >")
-            #endif
+            switch (prop.kind)
             {
-                nodeJson[prop.name] = ClassDB::GetProperty<std::string>(prop.name, node);
-            }
-            else if (prop.type == "bool")
+            case ClassDB::PropertyKind::Int:
+            case ClassDB::PropertyKind::Enum:
+                nodeJson[prop.name] = ClassDB::GetProperty<int>(id, node);
+                break;
+            case ClassDB::PropertyKind::Float:
+                nodeJson[prop.name] = ClassDB::GetProperty<float>(id, node);
+                break;
+            case ClassDB::PropertyKind::UnsignedInt:
+                nodeJson[prop.name] = ClassDB::GetProperty<unsigned int>(id, node);
+                break;
+            case ClassDB::PropertyKind::String:
+                nodeJson[prop.name] = ClassDB::GetProperty<std::string>(id, node);
+                break;
+            case ClassDB::PropertyKind::Bool:
+                nodeJson[prop.name] = ClassDB::GetProperty<bool>(id, node);
+                break;
+            case ClassDB::PropertyKind::Vector2f:
             {
-                nodeJson[prop.name] = ClassDB::GetProperty<bool>(prop.name, node);
+                auto v = ClassDB::GetPropertyPointer<Radium::Vector2f>(id, node);
+                nodeJson[prop.name] = {v->x, v->y};
+                break;
             }
-            else if (prop.type == "Radium::Vector2f")
+            case ClassDB::PropertyKind::RectangleF:
             {
-                auto v = ClassDB::GetProperty<Radium::Vector2f>(prop.name, node);
-                nodeJson[prop.name] = {v.x, v.y};
+                auto r = ClassDB::GetPropertyPointer<Radium::RectangleF>(id, node);
+                nodeJson[prop.name] = {r->x, r->y, r->w, r->h};
+                break;
             }
-            else if (prop.type == "Radium::RectangleF")
-            {
-                auto r = ClassDB::GetProperty<Radium::RectangleF>(prop.name, node);
-                nodeJson[prop.name] = {r.x, r.y, r.w, r.h};
+            default:
+                break;
             }
-            
         }
 
         // Recursively serialize children
@@ -222,59 +322,47 @@ namespace Radium::Nodes
             
             try
             {
-                if (ClassDB::IsEnum(prop.type)) {
-                    ClassDB::SetProperty<int>(prop.name, node, nodeJson[prop.name].get<int>());
-                }
+                ClassDB::PropertyId id = ClassDB::ResolveProperty(prop);
+                const json &value = nodeJson[prop.name];
 
-                if (prop.type == "int")
-                {
-                    ClassDB::SetProperty<int>(prop.name, node, nodeJson[prop.name].get<int>());
-                }
-                else if (prop.type == "float")
+                switch (prop.kind)
                 {
-                    ClassDB::SetProperty<float>(prop.name, node, nodeJson[prop.name].get<float>());
-                }
-                else if (prop.type == "unsigned int")
-                {
-                    ClassDB::SetProperty<unsigned int>(prop.name, node, nodeJson[prop.name].get<unsigned int>());
-                }
-                #if !defined(_MSC_VER)
-                #if defined(__EMSCRIPTEN__)
-                else if (prop.type == "std::__2::basic_string<char, std::__2::char_traits<char>, std::__2::allocator<char>>")
-                #else
-                #if defined(__ANDROID__)
-                else if (prop.type == "std::__ndk1::basic_string<char, std::__ndk1::char_traits<char>, std::__ndk1::allocator<char>>")
-                #else
-                else if (prop.type == "std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> >")
-                #endif
-                #endif
-                #else
-                else if (prop.type == "std::basic_string<char,struct std::char_traits<char>,class std::allocator<char> >")
-                #endif
-                {
-                    ClassDB::SetProperty<std::string>(prop.name, node, nodeJson[prop.name].get<std::string>());
-                }
-                else if (prop.type == "bool")
-                {
-                    ClassDB::SetProperty<bool>(prop.name, node, nodeJson[prop.name].get<bool>());
-                }
-                else if (prop.type == "Radium::Vector2f")
-                {
-                    auto arr = nodeJson[prop.name];
-                    if (arr.is_array() && arr.size() == 2)
+                case ClassDB::PropertyKind::Int:
+                case ClassDB::PropertyKind::Enum:
+                    ClassDB::SetProperty<int>(id, node, value.get<int>());
+                    break;
+                case ClassDB::PropertyKind::Float:
+                    ClassDB::SetProperty<float>(id, node, value.get<float>());
+                    break;
+                case ClassDB::PropertyKind::UnsignedInt:
+                    ClassDB::SetProperty<unsigned int>(id, node, value.get<unsigned int>());
+                    break;
+                case ClassDB::PropertyKind::String:
+                    ClassDB::SetProperty<std::string>(id, node, value.get<std::string>());
+                    break;
+                case ClassDB::PropertyKind::Bool:
+                    ClassDB::SetProperty<bool>(id, node, value.get<bool>());
+                    break;
+                case ClassDB::PropertyKind::Vector2f:
+                    if (value.is_array() && value.size() == 2)
                     {
-                        Radium::Vector2f v{arr[0].get<float>(), arr[1].get<float>()};
-                        ClassDB::SetProperty<Radium::Vector2f>(prop.name, node, v);
+                        auto v = ClassDB::GetPropertyPointer<Radium::Vector2f>(id, node);
+                        v->x = value[0].get<float>();
+                        v->y = value[1].get<float>();
                     }
-                }
-                else if (prop.type == "Radium::RectangleF")
-                {
-                    auto arr = nodeJson[prop.name];
-                    if (arr.is_array() && arr.size() == 4)
+                    break;
+                case ClassDB::PropertyKind::RectangleF:
+                    if (value.is_array() && value.size() == 4)
                     {
-                        Radium::RectangleF r{arr[0].get<float>(), arr[1].get<float>(), arr[2].get<float>(), arr[3].get<float>()};
-                        ClassDB::SetProperty<Radium::RectangleF>(prop.name, node, r);
+                        auto r = ClassDB::GetPropertyPointer<Radium::RectangleF>(id, node);
+                        r->x = value[0].get<float>();
+                        r->y = value[1].get<float>();
+                        r->w = value[2].get<float>();
+                        r->h = value[3].get<float>();
                     }
+                    break;
+                default:
+                    break;
                 }
             }
             catch (std::exception &e)
@@ -304,6 +392,19 @@ namespace Radium::Nodes
 
     void SceneTree::Deserialize(std::string path, bool stubScripts, bool external)
     {
+        const std::string binaryExtension = ".rscnb";
+        if (path.size() >= binaryExtension.size() && path.compare(path.size() - binaryExtension.size(), binaryExtension.size(), binaryExtension) == 0)
+        {
+            DeserializeBinary(path, stubScripts, external);
+            return;
+        }
+
+        std::string binaryPath = path + "b";
+        if (preferBinaryScenes && IsFileUpToDate(binaryPath, path, external) && DeserializeBinary(binaryPath, stubScripts, external))
+        {
+            return;
+        }
+
         std::string file = Radium::ReadFileToString(path, external);
 
         Flux::Trace("Got file: {}", file);
@@ -327,27 +428,15 @@ namespace Radium::Nodes
                 nodes.push_back(node);
             }
         }
-    }
-
-    // Recursive helper to update global position for node and all descendants
-    void UpdateGlobalPositionsRecursive(Node* node) {
-        if (!node) return;
-
-        // Try to cast to Node2D to call UpdateGlobalPosition
-        if (auto node2D = dynamic_cast<Node2D*>(node)) {
-            node2D->UpdateGlobals();
-        }
 
-        // Recurse for all children
-        for (auto* child : node->children) {
-            UpdateGlobalPositionsRecursive(child);
-        }
+        tickGroupsDirty = true;
+        spriteGridDirty = true;
     }
 
     // Call this on your SceneTree to update all nodes' global positions
     void SceneTree::UpdateAllGlobalPositions() {
         for (auto* rootNode : nodes) {
-            UpdateGlobalPositionsRecursive(rootNode);
+            rootNode->UpdateTransforms();
         }
     }
 
@@ -5,6 +5,7 @@
 #include <Radium/Nodes/Tree.hpp>
 #include <Radium/Nodes/Node.hpp>
 #include <Radium/Nodes/ClassDB.hpp>
+#include <Radium/Nodes/2D/SpriteGrid.hpp>
 #include <Radium/json.hpp>
 
 using json = nlohmann::json;
@@ -40,6 +41,25 @@ namespace Radium::Nodes {
          */
         std::vector<Node*> nodes;
 
+        /**
+         * Whether root subtrees without scripts or physics bodies are ticked in parallel on the
+         * application's job system. Subtrees that are not thread safe always tick on the calling
+         * thread, after the parallel ones.
+         */
+        bool parallelTick = true;
+
+        /**
+         * Whether Deserialize() loads a baked binary scene (the scene path plus "b", e.g.
+         * Main.rscnb) when one exists and is not older than the JSON scene.
+         */
+        bool preferBinaryScenes = true;
+
+        /**
+         * Whether sprites are kept in a SpriteGrid and only the ones inside the camera's visible
+         * area are drawn. Indexed sprites are drawn after the rest of the tree has rendered.
+         */
+        bool cullSprites = false;
+
         /**
          * @brief Called on program load
          */
@@ -78,13 +98,53 @@ namespace Radium::Nodes {
         /**
          * @brief Deerialize the scene from a file
          * 
-         * Deserialize the scene from a .json file. Includes nodes, scripts and children and the scene name etc
+         * Deserialize the scene from a .json file. Includes nodes, scripts and children and the scene name etc.
+         * Paths ending in .rscnb, or JSON scenes with an up to date baked sibling, load through DeserializeBinary().
          * @param path Path to the scene file
          * @param stubScripts Whether or not to actually load scripts.
          * @param external Whether the path is in assetfs or not. 
          */
         void Deserialize(std::string path, bool stubScripts = false, bool external = false);
 
+        /**
+         * @brief Serialize the scene to a binary file
+         * 
+         * Writes the same nodes, properties and scripts as Serialize() in the binary scene
+         * format, which loads with almost no parsing. JSON stays the authoring format.
+         * 
+         * @param path Path to the file, usually the JSON scene path plus "b"
+         */
+        void SerializeBinary(std::string path);
+
+        /**
+         * @brief Deserialize the scene from a binary file
+         * 
+         * The file is memory mapped where possible, and every class and property in it is
+         * resolved once up front rather than once per node.
+         * 
+         * @param path Path to the binary scene file
+         * @param stubScripts Whether or not to actually load scripts.
+         * @param external Whether the path is in assetfs or not.
+         * @return true if the scene was loaded, the tree is left untouched otherwise.
+         */
+        bool DeserializeBinary(std::string path, bool stubScripts = false, bool external = false);
+
+        /**
+         * @brief Re-sort root nodes into parallel and main thread tick groups
+         * 
+         * Done automatically when the root node list changes. Call it after attaching a script
+         * or physics body to a node that is already in the tree.
+         */
+        void RebuildTickGroups();
+
+        /**
+         * @brief Re-index the sprites used for culling
+         * 
+         * Done automatically when the root node list changes. Call it after adding, removing or
+         * reparenting sprites below the roots while cullSprites is on.
+         */
+        void RebuildSpriteGrid();
+
         /**
          * @brief Get a node from a path
          * 
@@ -93,6 +153,25 @@ namespace Radium::Nodes {
          * - /PipeGroup/TopPipe
          */
         Node* GetNodeByPath(std::string path);
+
+    private:
+        /// Root nodes whose whole subtree can tick on a worker thread
+        std::vector<Node*> parallelRoots;
+        /// Root nodes that must tick on the calling thread
+        std::vector<Node*> serialRoots;
+        /// Root list the groups were built from, used to notice changes
+        std::vector<Node*> tickGroupRoots;
+        /// Set when the groups must be rebuilt before the next parallel tick
+        bool tickGroupsDirty = true;
+
+        /// Spatial index of the sprites, used when cullSprites is on
+        SpriteGrid spriteGrid;
+        /// Root list the sprite grid was built from
+        std::vector<Node*> spriteGridRoots;
+        /// Set when the sprite grid must be rebuilt before the next render
+        bool spriteGridDirty = true;
+        /// Sprites found by the last culling query, kept to reuse the allocation
+        std::vector<Sprite2D*> visibleSprites;
     };
 
     /**
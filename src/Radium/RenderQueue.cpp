@@ -0,0 +1,142 @@
+#include <Radium/RenderQueue.hpp>
+#include <tracy/Tracy.hpp>
+#include <cstring>
+
+namespace Radium {
+    RenderQueue* RenderQueue::current = nullptr;
+
+    // Maps a float onto an unsigned integer with the same ordering, negative values included
+    static uint32_t sortable_float(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+    }
+
+    uint64_t RenderQueue::MakeKey(int layer, float z, SpriteBatchRegistry::Handle batch) {
+        // Bias the layer so negative layers sort before positive ones
+        uint64_t layerBits = (uint16_t)(layer + 0x8000);
+
+        return (layerBits << 48)
+            | ((uint64_t)sortable_float(z) << 16)
+            | (uint16_t)batch;
+    }
+
+    void RenderQueue::Push(int layer, const SpriteCommand& command) {
+        items.push_back({MakeKey(layer, command.z, command.batch), (uint32_t)commands.size()});
+        commands.push_back(command);
+    }
+
+    void RenderQueue::PushRun(int layer, float z, SpriteBatchRegistry::Handle batch, const SpriteCommand* commands, size_t count, float offsetX, float offsetY) {
+        if (count == 0) {
+            return;
+        }
+
+        items.push_back({MakeKey(layer, z, batch), (uint32_t)runs.size() | runBit});
+        runs.push_back({batch, runCommands.size(), count, offsetX, offsetY});
+        runCommands.insert(runCommands.end(), commands, commands + count);
+    }
+
+    void RenderQueue::Flush() {
+        ZoneScopedN("Render Queue Flush");
+
+        Sort();
+
+        SpriteBatchRegistry::Handle activeHandle = SpriteBatchRegistry::InvalidHandle;
+        Rune::SpriteBatch* active = nullptr;
+        auto bind = [&](SpriteBatchRegistry::Handle handle) {
+            if (handle == activeHandle) {
+                return;
+            }
+            if (active && active->started) {
+                active->End();
+            }
+            activeHandle = handle;
+            active = SpriteBatchRegistry::Get(activeHandle);
+            if (active && !active->started) {
+                active->Begin();
+            }
+        };
+
+        auto draw = [&](const SpriteCommand& command, float offsetX, float offsetY) {
+            active->DrawImageRect(
+                command.x + offsetX, command.y + offsetY,
+                command.width, command.height,
+                command.r, command.g, command.b,
+                command.sourceX, command.sourceY,
+                command.sourceWidth, command.sourceHeight,
+                command.textureWidth, command.textureHeight,
+                command.rotation, command.z, command.flags
+            );
+        };
+
+        for (const SortItem& item : items) {
+            if (item.index & runBit) {
+                const Run& run = runs[item.index & ~runBit];
+                bind(run.batch);
+                if (!active) {
+                    continue;
+                }
+
+                for (size_t i = 0; i < run.count; i++) {
+                    draw(runCommands[run.first + i], run.offsetX, run.offsetY);
+                }
+                continue;
+            }
+
+            const SpriteCommand& command = commands[item.index];
+            bind(command.batch);
+            if (!active) {
+                continue;
+            }
+
+            draw(command, 0, 0);
+        }
+
+        if (active && active->started) {
+            active->End();
+        }
+
+        commands.clear();
+        runs.clear();
+        runCommands.clear();
+        items.clear();
+    }
+
+    size_t RenderQueue::GetCount() const {
+        return commands.size() + runCommands.size();
+    }
+
+    void RenderQueue::Sort() {
+        size_t count = items.size();
+        if (count < 2) {
+            return;
+        }
+
+        scratch.resize(count);
+
+        // Least significant digit first, 8 bits per pass, every pass is stable
+        for (int shift = 0; shift < 64; shift += 8) {
+            size_t histogram[256] = {};
+            for (const SortItem& item : items) {
+                histogram[(item.key >> shift) & 0xFF]++;
+            }
+
+            // Every key has the same digit here, this pass would not move anything
+            if (histogram[(items[0].key >> shift) & 0xFF] == count) {
+                continue;
+            }
+
+            size_t offset = 0;
+            for (size_t& bucket : histogram) {
+                size_t size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+
+            for (const SortItem& item : items) {
+                scratch[histogram[(item.key >> shift) & 0xFF]++] = item;
+            }
+            items.swap(scratch);
+        }
+    }
+}
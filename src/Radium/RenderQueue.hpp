@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <Radium/SpriteBatchRegistry.hpp>
+
+namespace Radium {
+
+    /**
+     * @brief One sprite quad waiting to be submitted, with the arguments of SpriteBatch::DrawImageRect.
+     */
+    struct SpriteCommand {
+        SpriteBatchRegistry::Handle batch;
+        float x, y;
+        uint32_t width, height;
+        float r, g, b;
+        uint32_t sourceX, sourceY, sourceWidth, sourceHeight;
+        uint32_t textureWidth, textureHeight;
+        float rotation;
+        float z;
+        uint32_t flags;
+    };
+
+    /**
+     * @brief Collects the sprites of one render pass and submits them sorted.
+     *
+     * Every sprite gets a 64-bit sort key made of, from the most significant bits:
+     * layer (16 bits), z (32 bits) and batch handle (16 bits). Keys are radix sorted once when the
+     * queue is flushed. The sort is stable, so sprites with equal keys keep the order they
+     * were pushed in, which is the tree order. Sprites on the same layer and z end up next
+     * to the others using the same batch, so the batches are switched as little as possible
+     * while layering stays correct.
+     */
+    class RenderQueue {
+    public:
+        /**
+         * @brief Queue the sprites of the current render pass are pushed to, nullptr draws them immediately.
+         *
+         * Set by whoever owns the pass, like the Application or a SubViewport, while it renders.
+         */
+        static RenderQueue* current;
+
+        /**
+         * @brief Queue a sprite.
+         *
+         * @param layer Layer of the sprite, lower layers are drawn first.
+         * @param command The quad to draw.
+         */
+        void Push(int layer, const SpriteCommand& command);
+
+        /**
+         * @brief Queue a run of sprites sharing one sort key, drawn in order and moved by an offset.
+         *
+         * Used for instanced sprites, the run is sorted as a single item. Its commands are copied
+         * into the queue in one block, since a script rendering later in the pass may change the
+         * owner's array before Flush. The batch, z and layer of the commands themselves are not
+         * used for sorting.
+         *
+         * @param layer Layer of the run, lower layers are drawn first.
+         * @param z Z the run is sorted by.
+         * @param batch Batch every command of the run is drawn with.
+         * @param commands The quads to draw, positioned relative to the offset.
+         * @param count Number of commands.
+         * @param offsetX Added to the x of every command.
+         * @param offsetY Added to the y of every command.
+         */
+        void PushRun(int layer, float z, SpriteBatchRegistry::Handle batch, const SpriteCommand* commands, size_t count, float offsetX, float offsetY);
+
+        /**
+         * @brief Sort the queued sprites, draw them and empty the queue.
+         *
+         * Batches are begun as needed and ended before switching to another one, every batch is
+         * ended when this returns.
+         */
+        void Flush();
+
+        /**
+         * @brief Get the number of queued sprites, runs included.
+         */
+        size_t GetCount() const;
+
+    private:
+        struct SortItem {
+            uint64_t key;
+            uint32_t index;
+        };
+
+        struct Run {
+            SpriteBatchRegistry::Handle batch;
+            size_t first;
+            size_t count;
+            float offsetX, offsetY;
+        };
+
+        /// Set in SortItem::index when it refers to a run rather than a command
+        static constexpr uint32_t runBit = 0x80000000u;
+
+        std::vector<SpriteCommand> commands;
+        std::vector<Run> runs;
+        /// Commands of every run, back to back
+        std::vector<SpriteCommand> runCommands;
+        std::vector<SortItem> items;
+        std::vector<SortItem> scratch;
+
+        static uint64_t MakeKey(int layer, float z, SpriteBatchRegistry::Handle batch);
+
+        void Sort();
+    };
+}
@@ -1,18 +1,76 @@
 #include <Radium/SpriteBatchRegistry.hpp>
 #include <Radium/AssetLoader.hpp>
+#include <Radium/TextureAtlas.hpp>
+#include <map>
 #include <unordered_map>
 #include <SDL2/SDL.h>
 #include <Iris/Iris.hpp>
 #include <Flux/Flux.hpp>
 
 namespace Radium::SpriteBatchRegistry {
-    std::unordered_map<std::string, Rune::SpriteBatch*> map;
+    // Batches are stored densely by handle, the map is only used to resolve tags
+    static std::vector<Rune::SpriteBatch*> batches;
+    static std::unordered_map<std::string, Handle> handles;
+    static std::unordered_map<std::string, Region> regions;
+    static uint32_t generation = 0;
+    static bool headlessMode = false;
 
-    Rune::SpriteBatch* Get(std::string name) {
-        return map[name];
+    // Whether a tag other than name resolves to handle
+    static bool IsShared(const std::string& name, Handle handle) {
+        for (const auto& [tag, other] : handles) {
+            if (other == handle && tag != name) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Replacing a tag keeps its handle, so sprites that resolved it stay valid, unless the handle
+    // is shared with other atlas tags, which must keep their batch
+    static void Set(const std::string& name, Rune::SpriteBatch* batch) {
+        regions.erase(name);
+        generation++;
+
+        auto it = handles.find(name);
+        if (it != handles.end() && !IsShared(name, it->second)) {
+            batches[it->second] = batch;
+            return;
+        }
+
+        handles[name] = (Handle)batches.size();
+        batches.push_back(batch);
+    }
+
+    // Points a tag at the handle of a batch shared with other tags
+    static void Alias(const std::string& name, Handle handle) {
+        auto it = handles.find(name);
+        if (it != handles.end() && it->second == handle) {
+            return;
+        }
+
+        handles[name] = handle;
+        generation++;
+    }
+
+    Handle Find(const std::string& name) {
+        auto it = handles.find(name);
+        return it != handles.end() ? it->second : InvalidHandle;
+    }
+
+    Rune::SpriteBatch* Get(Handle handle) {
+        return handle < batches.size() ? batches[handle] : nullptr;
+    }
+
+    Rune::SpriteBatch* Get(const std::string& name) {
+        return Get(Find(name));
     }
 
     void Add(std::string name, std::string texturePath, Rune::SpriteOrigin origin, Rune::SamplingMode mode) {
+        if (headlessMode) {
+            Set(name, nullptr);
+            return;
+        }
+
         std::string resolvedPath = Radium::assetBase + texturePath;
         Iris::Image image = Iris::Image::Load(resolvedPath);
 
@@ -20,26 +78,94 @@ namespace Radium::SpriteBatchRegistry {
 
         Rune::Texture* texture = new Rune::Texture(image.width, image.height, 4 * image.width, image.data.data(), Rune::SamplingMode::Nearest);
         Rune::SpriteBatch* batch = new Rune::SpriteBatch(texture, origin);
-        map[name] = batch;
+        Set(name, batch);
     }
 
 
     void Add(std::string name, Rune::Texture* texture, Rune::SpriteOrigin origin, Rune::SamplingMode mode) {
+        if (headlessMode) {
+            Set(name, nullptr);
+            return;
+        }
+
         Rune::SpriteBatch* batch = new Rune::SpriteBatch(texture, origin);
-        map[name] = batch;
+        Set(name, batch);
     }
 
-    std::vector<Rune::SpriteBatch*> GetAll() {
-        std::vector<Rune::SpriteBatch*> batches;
+    void AddAtlas(const std::vector<AtlasEntry>& entries, uint32_t pageSize, Rune::SamplingMode mode) {
+        if (headlessMode) {
+            for (const AtlasEntry& entry : entries) {
+                Set(entry.name, nullptr);
+            }
+            return;
+        }
+
+        Radium::TextureAtlas atlas;
+        atlas.pageSize = pageSize;
+
+        std::vector<uint32_t> sources;
+        for (const AtlasEntry& entry : entries) {
+            sources.push_back(atlas.Add(entry.texturePath));
+        }
+        atlas.Pack();
+
+        auto& pages = atlas.GetPages();
+        std::vector<Rune::Texture*> textures;
+        for (auto& page : pages) {
+            textures.push_back(new Rune::Texture(page.width, page.height, 4 * page.width, page.pixels.data(), mode));
+        }
+        atlas.ReleasePixels();
+
+        // One batch per page and origin, the first tag owns the handle the others alias
+        std::map<std::pair<uint32_t, Rune::SpriteOrigin>, Handle> pageHandles;
+        for (size_t i = 0; i < entries.size(); i++) {
+            const AtlasEntry& entry = entries[i];
+            const auto& placement = atlas.GetPlacement(sources[i]);
 
-        for (auto pair : map) {
-            batches.push_back(pair.second);
+            auto key = std::make_pair(placement.page, entry.origin);
+            auto it = pageHandles.find(key);
+            if (it == pageHandles.end()) {
+                Set(entry.name, new Rune::SpriteBatch(textures[placement.page], entry.origin));
+                pageHandles.emplace(key, handles[entry.name]);
+            } else {
+                Alias(entry.name, it->second);
+            }
+
+            regions[entry.name] = {
+                placement.offsetX, placement.offsetY,
+                pages[placement.page].width, pages[placement.page].height
+            };
         }
 
+        // A tag aliased to the handle it already had can still have moved to a new region
+        generation++;
+    }
+
+    Region GetRegion(const std::string& name) {
+        auto it = regions.find(name);
+        return it != regions.end() ? it->second : Region{};
+    }
+
+    const std::vector<Rune::SpriteBatch*>& GetAll() {
         return batches;
     }
 
     void Clear() {
-        map.clear();
+        batches.clear();
+        handles.clear();
+        regions.clear();
+        generation++;
+    }
+
+    uint32_t GetGeneration() {
+        return generation;
+    }
+
+    void SetHeadless(bool headless) {
+        headlessMode = headless;
+    }
+
+    bool IsHeadless() {
+        return headlessMode;
     }
-}
\ No newline at end of file
+}
@@ -1,21 +1,71 @@
 #pragma once
 #include <Rune/SpriteBatch.hpp>
 #include <Rune/Texture.hpp>
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace Radium::SpriteBatchRegistry {
+    /// @brief Index of a batch in the registry, resolve it once from a tag with Find
+    using Handle = uint32_t;
+
+    /// @brief Handle of a tag that is not in the registry
+    constexpr Handle InvalidHandle = UINT32_MAX;
+
+    /// @brief Get the handle of a batch from its tag, InvalidHandle if there is none
+    Handle Find(const std::string& name);
+
+    /// @brief Get a sprite batch from its handle, nullptr for InvalidHandle or in headless mode
+    Rune::SpriteBatch* Get(Handle handle);
+
     /// @brief Get a sprite batch from the registry by its tag
-    Rune::SpriteBatch* Get(std::string name);
+    Rune::SpriteBatch* Get(const std::string& name);
 
     /// @brief Add a texture file to the registry as a batch
     void Add(std::string name, std::string texturePath, Rune::SpriteOrigin origin, Rune::SamplingMode mode);
-    
+
     /// @brief Add a texture from a Rune texture to the registry as a batch
     void Add(std::string name, Rune::Texture* texture, Rune::SpriteOrigin origin, Rune::SamplingMode mode);
-    
-    /// @brief Get all batches in the registty
-    std::vector<Rune::SpriteBatch*> GetAll();
+
+    /// @brief A sheet to pack into the shared atlas with AddAtlas
+    struct AtlasEntry {
+        std::string name;
+        std::string texturePath;
+        Rune::SpriteOrigin origin;
+    };
+
+    /// @brief Where the sheet of a tag lives in its batch texture, textureWidth is 0 when the tag is not packed
+    struct Region {
+        int offsetX = 0;
+        int offsetY = 0;
+        uint32_t textureWidth = 0;
+        uint32_t textureHeight = 0;
+    };
+
+    /**
+     * @brief Pack texture files into shared atlas pages and add them to the registry
+     *
+     * Tags on the same page with the same origin share one batch and one handle, so they are drawn
+     * together. Source rects stay in the coordinates of the original sheet, use GetRegion to map them.
+     */
+    void AddAtlas(const std::vector<AtlasEntry>& entries, uint32_t pageSize, Rune::SamplingMode mode);
+
+    /// @brief Get the atlas region of a tag
+    Region GetRegion(const std::string& name);
+
+    /// @brief Get all batches in the registry, indexed by handle
+    const std::vector<Rune::SpriteBatch*>& GetAll();
 
     /// @brief Clear the registry, freeing all batches
     void Clear();
-}
\ No newline at end of file
+
+    /// @brief Incremented whenever a handle, batch or region may resolve differently, by Clear or by adding or replacing a tag
+    uint32_t GetGeneration();
+
+    /// @brief In headless mode batches are only recorded by tag, no textures are loaded and Get returns nullptr
+    void SetHeadless(bool headless);
+
+    /// @brief Whether the registry is in headless mode
+    bool IsHeadless();
+}
@@ -1,5 +1,6 @@
 #include <Radium/SubViewport.hpp>
 #include <Radium/SpriteBatchRegistry.hpp>
+#include <Radium/RenderQueue.hpp>
 #include <Rune/Rune.hpp>
 #include <Rune/SpriteBatch.hpp>
 
@@ -22,8 +23,7 @@ namespace Radium {
 
     void SubViewport::OnRender() {
         // Update sprite batches' resolution uniform so shaders use the subviewport size
-        auto batchesPre = Radium::SpriteBatchRegistry::GetAll();
-        for (auto batch : batchesPre) {
+        for (auto batch : Radium::SpriteBatchRegistry::GetAll()) {
             if (batch && batch->resolutionBuffer) {
                 Rune::OtherDataUniform resData = {
                     .screenWidth = (float)viewport->width,
@@ -42,9 +42,12 @@ namespace Radium {
         // Create a render pass for this subviewport so sprite batches
         // rendered by the subscene have a valid activeRenderPass.
         viewport->SetupFrame();
+        RenderQueue* previousQueue = RenderQueue::current;
+        RenderQueue::current = &renderQueue;
         tree.OnRender();
-        auto batches = Radium::SpriteBatchRegistry::GetAll();
-        for (auto batch : batches) {
+        renderQueue.Flush();
+        RenderQueue::current = previousQueue;
+        for (auto batch : Radium::SpriteBatchRegistry::GetAll()) {
             if (!batch) {
                 continue;
             }
@@ -1,6 +1,7 @@
 #pragma once
 #include <Rune/Viewport.hpp>
 #include <Radium/Nodes/Tree.hpp>
+#include <Radium/RenderQueue.hpp>
 
 namespace Radium {
 
@@ -39,6 +40,11 @@ namespace Radium {
          */
         Nodes::SceneTree tree;
 
+        /**
+         * @brief Sorts the sprites of this viewport's render pass.
+         */
+        RenderQueue renderQueue;
+
         /**
          * @brief Called when the SubViewport is initialized.
          * 
@@ -0,0 +1,190 @@
+#include <Radium/TextureAtlas.hpp>
+#include <Radium/AssetLoader.hpp>
+#include <Radium/json.hpp>
+#include <Iris/Iris.hpp>
+#include <Flux/Flux.hpp>
+#include <tracy/Tracy.hpp>
+#include <algorithm>
+#include <cstring>
+
+using json = nlohmann::json;
+
+namespace Radium {
+    uint32_t TextureAtlas::Add(const std::string& path) {
+        for (uint32_t i = 0; i < sources.size(); i++) {
+            if (sources[i].path == path) {
+                return i;
+            }
+        }
+
+        Iris::Image image = Iris::Image::Load(assetBase + path);
+        Flux::Info("Loading texture at {} for the atlas", assetBase + path);
+
+        Source source;
+        source.path = path;
+        source.width = image.width;
+        source.height = image.height;
+        source.pixels = std::move(image.data);
+        source.trimWidth = source.width;
+        source.trimHeight = source.height;
+        Trim(source);
+
+        sources.push_back(std::move(source));
+        return (uint32_t)sources.size() - 1;
+    }
+
+    void TextureAtlas::Trim(Source& source) {
+        std::string framesPath = source.path.substr(0, source.path.find_last_of('.')) + ".json";
+        if (GetFileWriteTime(framesPath) == std::filesystem::file_time_type::min()) {
+            return;
+        }
+
+        json j = json::parse(ReadFileToString(framesPath), nullptr, false);
+        if (j.is_discarded() || !j.contains("frames") || !j["frames"].is_object() || j["frames"].empty()) {
+            Flux::Warn("TextureAtlas: Ignoring frames in {}, packing the whole sheet", framesPath);
+            return;
+        }
+
+        uint32_t minX = source.width, minY = source.height, maxX = 0, maxY = 0;
+        for (auto& [name, frame] : j["frames"].items()) {
+            const json& rect = frame.at("frame");
+            uint32_t x = rect.value("x", 0u);
+            uint32_t y = rect.value("y", 0u);
+            uint32_t w = rect.value("w", 0u);
+            uint32_t h = rect.value("h", 0u);
+
+            // Rotated frames are stored with their width and height swapped
+            if (frame.value("rotated", false)) {
+                std::swap(w, h);
+            }
+
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, std::min(x + w, source.width));
+            maxY = std::max(maxY, std::min(y + h, source.height));
+        }
+
+        if (maxX <= minX || maxY <= minY) {
+            return;
+        }
+
+        source.trimX = minX;
+        source.trimY = minY;
+        source.trimWidth = maxX - minX;
+        source.trimHeight = maxY - minY;
+    }
+
+    void TextureAtlas::Pack() {
+        ZoneScopedN("Texture Atlas Pack");
+
+        struct Shelf {
+            uint32_t y, height, cursorX;
+        };
+        struct PageState {
+            std::vector<Shelf> shelves;
+            uint32_t usedHeight = 0;
+            bool dedicated = false;
+        };
+
+        pages.clear();
+        std::vector<PageState> states;
+
+        // Tallest first keeps the shelves tight
+        std::vector<uint32_t> order(sources.size());
+        for (uint32_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return sources[a].trimHeight > sources[b].trimHeight;
+        });
+
+        for (uint32_t index : order) {
+            Source& source = sources[index];
+            uint32_t width = source.trimWidth + padding;
+            uint32_t height = source.trimHeight + padding;
+
+            uint32_t page = UINT32_MAX, x = 0, y = 0;
+
+            if (width > pageSize || height > pageSize) {
+                page = (uint32_t)pages.size();
+                pages.push_back({source.trimWidth, source.trimHeight, {}});
+                states.push_back({{}, source.trimHeight, true});
+            }
+
+            for (uint32_t p = 0; p < states.size() && page == UINT32_MAX; p++) {
+                PageState& state = states[p];
+                if (state.dedicated) {
+                    continue;
+                }
+
+                for (Shelf& shelf : state.shelves) {
+                    if (height <= shelf.height && shelf.cursorX + width <= pageSize) {
+                        page = p;
+                        x = shelf.cursorX;
+                        y = shelf.y;
+                        shelf.cursorX += width;
+                        break;
+                    }
+                }
+
+                if (page == UINT32_MAX && state.usedHeight + height <= pageSize) {
+                    page = p;
+                    y = state.usedHeight;
+                    state.shelves.push_back({y, height, width});
+                    state.usedHeight += height;
+                }
+            }
+
+            if (page == UINT32_MAX) {
+                page = (uint32_t)pages.size();
+                pages.push_back({pageSize, 0, {}});
+                states.push_back({{{0, height, width}}, height, false});
+            }
+
+            source.placement.page = page;
+            source.placement.offsetX = (int)x - (int)source.trimX;
+            source.placement.offsetY = (int)y - (int)source.trimY;
+        }
+
+        for (uint32_t p = 0; p < pages.size(); p++) {
+            if (!states[p].dedicated) {
+                pages[p].height = states[p].usedHeight;
+            }
+            pages[p].pixels.assign((size_t)pages[p].width * pages[p].height * 4, 0);
+        }
+
+        for (Source& source : sources) {
+            Page& page = pages[source.placement.page];
+            uint32_t x = source.trimX + source.placement.offsetX;
+            uint32_t y = source.trimY + source.placement.offsetY;
+
+            for (uint32_t row = 0; row < source.trimHeight; row++) {
+                std::memcpy(
+                    &page.pixels[(((size_t)y + row) * page.width + x) * 4],
+                    &source.pixels[(((size_t)source.trimY + row) * source.width + source.trimX) * 4],
+                    (size_t)source.trimWidth * 4
+                );
+            }
+
+            source.pixels.clear();
+            source.pixels.shrink_to_fit();
+        }
+
+        Flux::Info("TextureAtlas: Packed {} sheets into {} pages", sources.size(), pages.size());
+    }
+
+    const TextureAtlas::Placement& TextureAtlas::GetPlacement(uint32_t source) const {
+        return sources[source].placement;
+    }
+
+    std::vector<TextureAtlas::Page>& TextureAtlas::GetPages() {
+        return pages;
+    }
+
+    void TextureAtlas::ReleasePixels() {
+        for (Page& page : pages) {
+            page.pixels.clear();
+            page.pixels.shrink_to_fit();
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Radium {
+
+    /**
+     * @brief Packs several sprite sheets into shared RGBA pages on the CPU.
+     *
+     * Each sheet is packed whole, so a rectangle in sheet coordinates maps to the page by a
+     * constant offset and source rects animated by scripts keep working. When a TexturePacker
+     * style frames JSON sits next to the sheet (sprites/texture.png and sprites/texture.json),
+     * the sheet is trimmed to the bounding box of its frames first, dropping unused space.
+     */
+    class TextureAtlas {
+    public:
+        /// @brief Where a sheet ended up, add the offset to a rectangle in sheet coordinates.
+        struct Placement {
+            uint32_t page = 0;
+            int offsetX = 0;
+            int offsetY = 0;
+        };
+
+        /// @brief One packed page, RGBA with 4 bytes per pixel.
+        struct Page {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            std::vector<uint8_t> pixels;
+        };
+
+        /// Width and maximum height of a page, sheets larger than this get a page of their own.
+        uint32_t pageSize = 2048;
+
+        /// Transparent pixels left between sheets so filtering never reads a neighbour.
+        uint32_t padding = 1;
+
+        /**
+         * @brief Load a sheet to be packed.
+         *
+         * @param path A path to the image in assetfs.
+         * @return Index of the sheet, adding the same path twice returns the same index.
+         */
+        uint32_t Add(const std::string& path);
+
+        /**
+         * @brief Pack every added sheet and build the pages.
+         *
+         * The loaded sheets are released once they are copied into the pages.
+         */
+        void Pack();
+
+        /// @brief Get the placement of a sheet, valid after Pack.
+        const Placement& GetPlacement(uint32_t source) const;
+
+        /// @brief Get the packed pages, valid after Pack.
+        std::vector<Page>& GetPages();
+
+        /// @brief Free the pixels of the pages once they are uploaded, placements stay valid.
+        void ReleasePixels();
+
+    private:
+        struct Source {
+            std::string path;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            std::vector<uint8_t> pixels;
+
+            // Part of the sheet that is packed
+            uint32_t trimX = 0;
+            uint32_t trimY = 0;
+            uint32_t trimWidth = 0;
+            uint32_t trimHeight = 0;
+
+            Placement placement;
+        };
+
+        std::vector<Source> sources;
+        std::vector<Page> pages;
+
+        void Trim(Source& source);
+    };
+}
@@ -4,11 +4,13 @@
 #include <Radium/Camera.hpp>
 #include <Radium/SpriteBatchRegistry.hpp>
 #include <Radium/Nodes/2D/Sprite2D.hpp>
+#include <Radium/Nodes/2D/SpriteInstances2D.hpp>
 #include <Radium/Nodes/2D/Node2D.hpp>
 #include <Radium/Nodes/2D/TileMap2D.hpp>
 #include <Radium/Nodes/2D/RigidBody.hpp>
 #include <Radium/Nodes/Node.hpp>
 #include <Radium/Nodes/Node.hpp>
+#include <Radium/Nodes/LuaScript.hpp>
 #include <Radium/PhysicsUtil.hpp>
 #include <Radium/Input.hpp>
 #include <Rune/Texture.hpp>
@@ -30,8 +32,16 @@ public:
     Radium::TTFFont* font;
 
     void OnPreLoad(int argc, char* argv[]) override {
-        if (argc > 1) {
-            appBase = std::string(argv[1]);
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--frames") {
+                i++;
+                continue;
+            }
+            if (arg.rfind("--", 0) != 0) {
+                appBase = arg;
+                break;
+            }
         }
         std::string configPath = appBase + "/app.json";
         if (appBase == "") {
@@ -41,6 +51,19 @@ public:
         Flux::Info("App config file: {}", appConfig);
         json j = json::parse(appConfig);
         config = j.get<Radium::GameConfig>();
+        tickRate = config.tickRate;
+        jobThreadCount = config.jobThreads;
+        tree.cullSprites = config.cullSprites;
+        Radium::Nodes::Lua::persistCompiledChunks = config.compiledScriptCache;
+        Radium::Nodes::Lua::scheduler.budgetMs = config.scriptBudgetMs;
+        if (config.scriptGc == "generational") {
+            Radium::Nodes::Lua::memory.gcMode = Radium::Nodes::LuaGcMode::Generational;
+        } else if (config.scriptGc == "stepped") {
+            Radium::Nodes::Lua::memory.gcMode = Radium::Nodes::LuaGcMode::Stepped;
+        }
+        Radium::Nodes::Lua::memory.stepKb = config.scriptGcStepKb;
+        Radium::Nodes::Lua::memory.scriptLimit = (size_t)config.scriptMemoryLimitKb * 1024;
+        Radium::Nodes::Lua::memory.limit = (size_t)config.scriptMemoryTotalLimitKb * 1024;
     }
 
     std::string GetTitle() override
@@ -67,9 +90,18 @@ public:
         Radium::assetBase = appBase + "/";
         #endif
 
-        for (auto batchInfo : config.spriteBatches) {
-            Flux::Info("Add batch {} from {}", batchInfo.tag, batchInfo.path);
-            Radium::SpriteBatchRegistry::Add(batchInfo.tag, batchInfo.path, batchInfo.origin, Rune::SamplingMode::Nearest);
+        if (config.packAtlas) {
+            std::vector<Radium::SpriteBatchRegistry::AtlasEntry> entries;
+            for (auto batchInfo : config.spriteBatches) {
+                Flux::Info("Add batch {} from {} to the atlas", batchInfo.tag, batchInfo.path);
+                entries.push_back({batchInfo.tag, batchInfo.path, batchInfo.origin});
+            }
+            Radium::SpriteBatchRegistry::AddAtlas(entries, (uint32_t)config.atlasPageSize, Rune::SamplingMode::Nearest);
+        } else {
+            for (auto batchInfo : config.spriteBatches) {
+                Flux::Info("Add batch {} from {}", batchInfo.tag, batchInfo.path);
+                Radium::SpriteBatchRegistry::Add(batchInfo.tag, batchInfo.path, batchInfo.origin, Rune::SamplingMode::Nearest);
+            }
         }
 
         Radium::Vector2f::Register();
@@ -79,6 +111,7 @@ public:
         Radium::Nodes::Node::Register();
         Radium::Nodes::Node2D::Register();
         Radium::Nodes::Sprite2D::Register();
+        Radium::Nodes::SpriteInstances2D::Register();
         Radium::Nodes::TileMap2D::Register();
         Radium::Nodes::RigidBody::Register();
         Radium::Camera::Register();